@@ -0,0 +1,57 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace bench
+{
+
+// Runs the function the given number of passes and returns the elapsed milliseconds.
+template <typename Func>
+double timeMs(tp::UInt passes, Func &&func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (tp::UInt i = 0; i < passes; ++i)
+    {
+        func();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Synthetic log rows with a timestamp, a level, a request id and a message, some of them with non-ascii text.
+inline std::vector<std::string> makeRows(tp::UInt count, std::uint32_t seed = 7)
+{
+    static const char *levels[] = {"INFO", "DEBUG", "WARN", "ERROR"};
+    static const char *messages[] = {
+        "request handled by the service in the expected time",
+        "connection timeout while waiting for the upstream server",
+        "user_id=%u logged in from the mobile application",
+        "Überprüfung der Sitzung abgeschlossen für den Benutzer",
+        "cache miss for key session:%u, loading from the database"};
+
+    std::mt19937 rng(seed);
+    std::vector<std::string> rows;
+    rows.reserve(count);
+    for (tp::UInt i = 0; i < count; ++i)
+    {
+        char message[128];
+        std::snprintf(message, sizeof(message), messages[rng() % std::size(messages)], rng() % 100000);
+        rows.push_back(fmt::format(
+            "2022-03-{:02} {:02}:{:02}:{:02}.{:03} [{}] req-{:04x} {}",
+            1 + (i / 86400) % 28,
+            (i / 3600) % 24,
+            (i / 60) % 60,
+            i % 60,
+            rng() % 1000,
+            levels[rng() % std::size(levels)],
+            rng() % 0x10000,
+            message));
+    }
+    return rows;
+}
+
+} // namespace bench
@@ -0,0 +1,44 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "LineBreaks.h"
+#include "Bench.h"
+
+// Throughput of each line breaks scanner over an in-memory log, in the 16 KB blocks used by the indexer.
+int main()
+{
+    constexpr tp::UInt blockSize(16 * 1024);
+    constexpr tp::UInt passes(5);
+
+    std::string data;
+    for (const auto &row : bench::makeRows(2000000))
+    {
+        data.append(row).push_back('\n');
+    }
+
+    const double dataGB(data.size() / (1024.0 * 1024.0 * 1024.0));
+    std::printf("%.2f GB of rows, default scanner: %s\n", dataGB, utl::lineBreaksScannerName());
+
+    for (const auto &scanner : utl::lineBreaksScanners())
+    {
+        tp::UInt lineBreaks(0);
+        const double elapsed = bench::timeMs(
+            passes,
+            [&]()
+            {
+                for (tp::UInt pos = 0; pos < data.size(); pos += blockSize)
+                {
+                    const tp::UInt size(std::min<tp::UInt>(blockSize, data.size() - pos));
+                    lineBreaks += scanner.scan(data.data() + pos, size).count;
+                }
+            });
+        std::printf(
+            "%-8s %8.1f ms %6.2f GB/s (%zu line breaks)\n",
+            scanner.name,
+            elapsed,
+            (dataGB * passes * 1000.0) / elapsed,
+            static_cast<size_t>(lineBreaks / passes));
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "RangeMatcher.h"
+#include "Bench.h"
+
+namespace
+{
+
+struct Case
+{
+    tp::ColumnType type;
+    std::string format;
+    std::string pattern;
+    std::vector<std::string> values;
+};
+
+// The comparison done by RangeMatcher before the typed kernels, converting every value to a variant.
+bool matchVariant(const tp::Column &column, const QVariant &from, const QVariant &to, const std::string &text)
+{
+    const auto val(utl::toVariant(column, QString::fromUtf8(text.data(), text.size())));
+    return val.isValid() && !val.isNull() && (QVariant::compare(val, from) >= 0) && (QVariant::compare(val, to) <= 0);
+}
+
+} // namespace
+
+// Range matching of the int, float and time columns by the typed kernels of RangeMatcher against
+// utl::toVariant and QVariant::compare.
+int main()
+{
+    constexpr tp::UInt passes(3);
+    constexpr tp::UInt count(200000);
+    const auto rows = bench::makeRows(count);
+
+    std::mt19937 rng(7);
+    std::vector<Case> cases;
+    cases.push_back({tp::ColumnType::Int, std::string(), "-250000 -> 250000", {}});
+    cases.push_back({tp::ColumnType::UInt, std::string(), "100000 -> 600000", {}});
+    cases.push_back({tp::ColumnType::Float, std::string(), "0.25 -> 0.75", {}});
+    cases.push_back(
+        {tp::ColumnType::Time,
+         "yyyy-MM-dd HH:mm:ss.zzz",
+         "2022-03-01 12:00:00.000 -> 2022-03-02 12:00:00.000",
+         {}});
+    for (tp::UInt i = 0; i < count; ++i)
+    {
+        cases[0].values.push_back(std::to_string(static_cast<std::int64_t>(rng() % 1000000) - 500000));
+        cases[1].values.push_back(std::to_string(rng() % 1000000));
+        cases[2].values.push_back(fmt::format("{:.6f}", static_cast<double>(rng() % 1000000) / 1000000));
+        cases[3].values.push_back(rows[i].substr(0, cases[3].format.size()));
+    }
+
+    for (const auto &testCase : cases)
+    {
+        tp::SearchParam param;
+        param.type = tp::SearchType::Range;
+        param.pattern = testCase.pattern;
+        param.column = tp::Column(0);
+        param.column->type = testCase.type;
+        param.column->format = testCase.format;
+
+        const auto [fromText, toText] = RangeMatcher::splitBounds(testCase.pattern);
+        const QVariant from(utl::toVariant(param.column.value(), QString::fromStdString(fromText)));
+        const QVariant to(utl::toVariant(param.column.value(), QString::fromStdString(toText)));
+        tp::UInt variantFound(0);
+        const double variantElapsed = bench::timeMs(
+            passes,
+            [&]()
+            {
+                for (const auto &value : testCase.values)
+                    variantFound += matchVariant(param.column.value(), from, to, value);
+            });
+
+        RangeMatcher matcher(param);
+        tp::UInt matcherFound(0);
+        const double matcherElapsed = bench::timeMs(
+            passes,
+            [&]()
+            {
+                for (const auto &value : testCase.values)
+                    matcherFound += matcher.match(value);
+            });
+
+        std::printf(
+            "'%s': toVariant+compare %.1f ms (%zu), RangeMatcher %.1f ms (%zu)\n",
+            testCase.pattern.c_str(),
+            variantElapsed,
+            static_cast<size_t>(variantFound / passes),
+            matcherElapsed,
+            static_cast<size_t>(matcherFound / passes));
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "Utf8Regex.h"
+#include "Bench.h"
+
+// Matching of Utf8Regex against converting every row to utf-16 for QRegularExpression.
+int main()
+{
+    constexpr tp::UInt passes(3);
+    const auto rows = bench::makeRows(500000);
+
+    const std::vector<std::pair<std::string, bool>> patterns{
+        {R"(user_id=\d+ .*application)", true},
+        {"error|timeout", false},
+        {R"(^(\S+) (\S+) \[(\w+)\] (.*)$)", true}};
+
+    for (const auto &[pattern, matchCase] : patterns)
+    {
+        QRegularExpression qtRegex(QString::fromStdString(pattern));
+        if (!matchCase)
+            qtRegex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+        qtRegex.optimize();
+
+        tp::UInt qtFound(0);
+        const double qtElapsed = bench::timeMs(
+            passes,
+            [&]()
+            {
+                for (const auto &row : rows)
+                    qtFound += qtRegex.match(QString::fromUtf8(row.data(), row.size())).hasMatch();
+            });
+
+        const Utf8Regex regex(pattern, matchCase, false);
+        tp::UInt utf8Found(0);
+        const double utf8Elapsed = bench::timeMs(
+            passes,
+            [&]()
+            {
+                for (const auto &row : rows)
+                    utf8Found += regex.match(row);
+            });
+
+        std::printf(
+            "'%s'%s: QRegularExpression %.1f ms (%zu), Utf8Regex %.1f ms (%zu)\n",
+            pattern.c_str(),
+            matchCase ? "" : " ignoring the case",
+            qtElapsed,
+            static_cast<size_t>(qtFound / passes),
+            utf8Elapsed,
+            static_cast<size_t>(utf8Found / passes));
+    }
+    return 0;
+}
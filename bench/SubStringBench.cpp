@@ -0,0 +1,60 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "SubStringMatcher.h"
+#include "Bench.h"
+
+// Case insensitive substring search of SubStringMatcher against upper-casing a copy of every cell, and against
+// converting every cell to QString, which was used for the non-ascii patterns.
+int main()
+{
+    constexpr tp::UInt passes(5);
+    const auto rows = bench::makeRows(200000);
+
+    for (const std::string pattern : {"e", "req-4f2a", "connection timeout", "überprüfung"})
+    {
+        const std::string upperPattern(utl::toUpper(pattern));
+        tp::UInt copyFound(0);
+        const double copyElapsed = bench::timeMs(
+            passes,
+            [&]()
+            {
+                for (const auto &row : rows)
+                    copyFound += (utl::toUpper(row).find(upperPattern) != std::string::npos);
+            });
+
+        const QString qtPattern(QString::fromStdString(pattern));
+        tp::UInt qtFound(0);
+        const double qtElapsed = bench::timeMs(
+            passes,
+            [&]()
+            {
+                for (const auto &row : rows)
+                    qtFound += QString::fromUtf8(row.data(), row.size()).contains(qtPattern, Qt::CaseInsensitive);
+            });
+
+        tp::SearchParam param;
+        param.pattern = pattern;
+        SubStringMatcher matcher(param);
+        tp::UInt matcherFound(0);
+        const double matcherElapsed = bench::timeMs(
+            passes,
+            [&]()
+            {
+                for (const auto &row : rows)
+                    matcherFound += matcher.match(row);
+            });
+
+        std::printf(
+            "'%s': toUpper+find %.1f ms (%zu), QString %.1f ms (%zu), SubStringMatcher %.1f ms (%zu)\n",
+            pattern.c_str(),
+            copyElapsed,
+            static_cast<size_t>(copyFound / passes),
+            qtElapsed,
+            static_cast<size_t>(qtFound / passes),
+            matcherElapsed,
+            static_cast<size_t>(matcherFound / passes));
+    }
+    return 0;
+}
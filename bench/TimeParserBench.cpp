@@ -0,0 +1,48 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "TimeParser.h"
+#include "Bench.h"
+
+// Parsing of the timestamps by TimeParser against QDateTime::fromString.
+int main()
+{
+    constexpr tp::UInt passes(3);
+    const QString qtFormat("yyyy-MM-dd HH:mm:ss.zzz");
+    const TimeParser parser(utl::toStr(qtFormat));
+
+    std::vector<std::string> times;
+    for (const auto &row : bench::makeRows(200000))
+    {
+        times.push_back(row.substr(0, qtFormat.size()));
+    }
+
+    tp::UInt qtParsed(0);
+    const double qtElapsed = bench::timeMs(
+        passes,
+        [&]()
+        {
+            for (const auto &time : times)
+                qtParsed += QDateTime::fromString(QString::fromStdString(time), qtFormat).isValid();
+        });
+
+    tp::UInt parsed(0);
+    const double elapsed = bench::timeMs(
+        passes,
+        [&]()
+        {
+            for (const auto &time : times)
+                parsed += parser.parse(time).has_value();
+        });
+
+    std::printf(
+        "'%s' (%s): QDateTime::fromString %.1f ms (%zu), TimeParser %.1f ms (%zu)\n",
+        parser.getFormat().c_str(),
+        parser.isCompiled() ? "compiled" : "by QDateTime",
+        qtElapsed,
+        static_cast<size_t>(qtParsed / passes),
+        elapsed,
+        static_cast<size_t>(parsed / passes));
+    return 0;
+}
@@ -0,0 +1,631 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "Decompressor.h"
+#include <cstring>
+#include <mutex>
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+// Data before a checkpoint that is required to resume the decompression (deflate distance limit).
+constexpr tp::UInt g_windowSize(32 * 1024);
+constexpr tp::UInt g_outSize(256 * 1024);
+constexpr tp::UInt g_inSize(64 * 1024);
+// Minimal distance in uncompressed bytes between checkpoints. Seeking decompresses half of it on average,
+// and each gzip checkpoint keeps a compressed copy of its window.
+constexpr tp::UInt g_checkpointSpan(4 * 1024 * 1024);
+
+struct DecompressCheckpoint
+{
+    // Position in the compressed data.
+    tp::UInt in = 0;
+    // Position in the uncompressed data.
+    tp::UInt out = 0;
+    // Bits of the byte before in that still belong to the data (gzip only).
+    int bits = 0;
+    tp::UInt windowSize = 0;
+    // The window, compressed to save memory.
+    std::string window;
+};
+
+class DecompressIndex
+{
+public:
+    // Nearest checkpoint at or before pos. The beginning of the data is not a checkpoint.
+    std::optional<DecompressCheckpoint> find(tp::UInt pos) const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), pos, compare);
+        if (it == m_checkpoints.begin())
+        {
+            return std::nullopt;
+        }
+        return *(--it);
+    }
+
+    tp::UInt findPos(tp::UInt pos) const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), pos, compare);
+        return (it == m_checkpoints.begin()) ? 0 : (--it)->out;
+    }
+
+    tp::UInt lastPos() const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return m_checkpoints.empty() ? 0 : m_checkpoints.back().out;
+    }
+
+    // Whether a checkpoint at pos would be far enough from the existing ones.
+    bool wants(tp::UInt pos) const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), pos, compare);
+        const tp::UInt prevPos((it == m_checkpoints.begin()) ? 0 : std::prev(it)->out);
+        return ((pos - prevPos) >= g_checkpointSpan) &&
+               ((it == m_checkpoints.end()) || ((it->out - pos) >= g_checkpointSpan));
+    }
+
+    void add(DecompressCheckpoint &&checkpoint)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), checkpoint.out, compare);
+        m_memorySize += sizeof(DecompressCheckpoint) + checkpoint.window.size();
+        m_checkpoints.insert(it, std::move(checkpoint));
+    }
+
+    // Size of the uncompressed data, if it was reached when the compressed data had rawSize bytes.
+    std::optional<tp::UInt> getEnd(tp::UInt rawSize) const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_end.has_value() && (m_end->first == rawSize))
+        {
+            return m_end->second;
+        }
+        return std::nullopt;
+    }
+
+    void setEnd(tp::UInt endPos, tp::UInt rawSize)
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_end = std::make_pair(rawSize, endPos);
+    }
+
+    tp::UInt count() const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return m_checkpoints.size();
+    }
+
+    tp::UInt memorySize() const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return m_memorySize;
+    }
+
+private:
+    static bool compare(tp::UInt pos, const DecompressCheckpoint &checkpoint) { return pos < checkpoint.out; }
+
+    mutable std::mutex m_mutex;
+    std::vector<DecompressCheckpoint> m_checkpoints;
+    std::optional<std::pair<tp::UInt, tp::UInt>> m_end;
+    tp::UInt m_memorySize = 0;
+};
+
+class DecoderImp
+{
+public:
+    DecoderImp(std::istream &raw, DecompressIndex &index) : m_raw(raw), m_index(index), m_in(g_inSize, '\0') {}
+    virtual ~DecoderImp() = default;
+
+    // Restarts the decompression at the checkpoint, or at the beginning of the data if there is none.
+    // The uncompressed window before the checkpoint is returned.
+    virtual bool restart(const std::optional<DecompressCheckpoint> &checkpoint, std::string &window) = 0;
+
+    // Decompresses into out[outLen, outSize), where out[0, outLen) holds the data decompressed right before,
+    // starting at the uncompressed position outPos. Returns the number of bytes decompressed, 0 at the end.
+    virtual tp::UInt decode(char *out, tp::UInt outLen, tp::UInt outSize, tp::UInt outPos) = 0;
+
+protected:
+    // Reads the next compressed block into m_in. The position is restored on every read, as other
+    // users of the raw stream may move it.
+    tp::UInt readInput()
+    {
+        m_raw.clear();
+        m_raw.seekg(m_inPos, std::ios::beg);
+        m_raw.read(m_in.data(), m_in.size());
+        const tp::UInt readBytes(std::max<std::streamsize>(m_raw.gcount(), 0));
+        m_inPos += readBytes;
+        return readBytes;
+    }
+
+    std::istream &m_raw;
+    DecompressIndex &m_index;
+    std::string m_in;
+    // Position in the compressed data of the next read.
+    tp::UInt m_inPos = 0;
+};
+
+#if defined(HAVE_ZLIB)
+
+// Seekable gzip decompression, based on the zran example of zlib. The checkpoints are taken at the deflate
+// block boundaries, where the decompression can be resumed in raw mode from the bit position and the window.
+class GzipDecoder : public DecoderImp
+{
+public:
+    GzipDecoder(std::istream &raw, DecompressIndex &index) : DecoderImp(raw, index)
+    {
+        // Automatic gzip or zlib header detection.
+        m_initialized = (inflateInit2(&m_strm, 47) == Z_OK);
+    }
+
+    ~GzipDecoder()
+    {
+        if (m_initialized)
+        {
+            inflateEnd(&m_strm);
+        }
+    }
+
+    bool restart(const std::optional<DecompressCheckpoint> &checkpoint, std::string &window) override
+    {
+        if (!m_initialized)
+        {
+            return false;
+        }
+
+        m_strm.next_in = Z_NULL;
+        m_strm.avail_in = 0;
+        m_ended = false;
+        m_newMember = false;
+        window.clear();
+
+        if (!checkpoint.has_value())
+        {
+            m_inPos = 0;
+            m_rawDeflate = false;
+            return (inflateReset2(&m_strm, 47) == Z_OK);
+        }
+
+        m_rawDeflate = true;
+        m_inPos = checkpoint->in - (checkpoint->bits ? 1 : 0);
+        if (inflateReset2(&m_strm, -15) != Z_OK)
+        {
+            return false;
+        }
+
+        if (checkpoint->bits)
+        {
+            m_raw.clear();
+            m_raw.seekg(m_inPos, std::ios::beg);
+            const auto byte = m_raw.get();
+            if (byte == std::istream::traits_type::eof())
+            {
+                return false;
+            }
+            ++m_inPos;
+            inflatePrime(&m_strm, checkpoint->bits, byte >> (8 - checkpoint->bits));
+        }
+
+        window.resize(checkpoint->windowSize);
+        uLongf windowSize(checkpoint->windowSize);
+        if ((uncompress(
+                 reinterpret_cast<Bytef *>(window.data()),
+                 &windowSize,
+                 reinterpret_cast<const Bytef *>(checkpoint->window.data()),
+                 checkpoint->window.size()) != Z_OK) ||
+            (windowSize != checkpoint->windowSize))
+        {
+            return false;
+        }
+
+        return (inflateSetDictionary(&m_strm, reinterpret_cast<const Bytef *>(window.data()), windowSize) == Z_OK);
+    }
+
+    tp::UInt decode(char *out, tp::UInt outLen, tp::UInt outSize, tp::UInt outPos) override
+    {
+        m_strm.next_out = reinterpret_cast<Bytef *>(out + outLen);
+        m_strm.avail_out = outSize - outLen;
+
+        while (!m_ended && (m_strm.avail_out > 0))
+        {
+            if (m_strm.avail_in == 0)
+            {
+                m_strm.avail_in = readInput();
+                m_strm.next_in = reinterpret_cast<Bytef *>(m_in.data());
+                if (m_strm.avail_in == 0)
+                {
+                    // The file may still be growing, so it's not the end yet.
+                    break;
+                }
+            }
+
+            const int res = inflate(&m_strm, Z_BLOCK);
+            const tp::UInt decoded(reinterpret_cast<char *>(m_strm.next_out) - out);
+            if (res == Z_STREAM_END)
+            {
+                nextMember();
+            }
+            else if ((res != Z_OK) && (res != Z_BUF_ERROR))
+            {
+                if (m_newMember)
+                {
+                    LOG_WAR("Ignoring the data after the last gzip member at {}", m_inPos - m_strm.avail_in);
+                }
+                else
+                {
+                    LOG_ERR("Invalid gzip data at {}: {}", m_inPos - m_strm.avail_in, m_strm.msg ? m_strm.msg : "");
+                }
+                m_ended = true;
+            }
+            else if ((m_strm.data_type & 128) && !(m_strm.data_type & 64))
+            {
+                m_newMember = false;
+                addCheckpoint(out, decoded, outPos);
+            }
+        }
+
+        return (outSize - outLen) - m_strm.avail_out;
+    }
+
+private:
+    // Concatenated gzip members are decompressed as a single stream.
+    void nextMember()
+    {
+        // The trailer (CRC32 and ISIZE) is consumed by zlib only when the header was read.
+        if (m_rawDeflate)
+        {
+            constexpr tp::UInt trailerSize(8);
+            const tp::UInt skipped(std::min<tp::UInt>(trailerSize, m_strm.avail_in));
+            m_strm.next_in += skipped;
+            m_strm.avail_in -= skipped;
+            m_inPos += trailerSize - skipped;
+            m_rawDeflate = false;
+        }
+        m_newMember = true;
+        m_ended = (inflateReset2(&m_strm, 47) != Z_OK);
+    }
+
+    void addCheckpoint(const char *out, tp::UInt decoded, tp::UInt outPos)
+    {
+        const tp::UInt pos(outPos + decoded);
+        const tp::UInt windowSize(std::min(decoded, g_windowSize));
+        if (((outPos > 0) && (windowSize < g_windowSize)) || !m_index.wants(pos))
+        {
+            return;
+        }
+
+        DecompressCheckpoint checkpoint;
+        checkpoint.in = m_inPos - m_strm.avail_in;
+        checkpoint.out = pos;
+        checkpoint.bits = m_strm.data_type & 7;
+        checkpoint.windowSize = windowSize;
+        uLongf compressedSize(compressBound(windowSize));
+        checkpoint.window.resize(compressedSize);
+        if (compress2(
+                reinterpret_cast<Bytef *>(checkpoint.window.data()),
+                &compressedSize,
+                reinterpret_cast<const Bytef *>(out + decoded - windowSize),
+                windowSize,
+                Z_BEST_SPEED) != Z_OK)
+        {
+            return;
+        }
+        checkpoint.window.resize(compressedSize);
+        checkpoint.window.shrink_to_fit();
+        m_index.add(std::move(checkpoint));
+    }
+
+    z_stream m_strm{};
+    bool m_initialized = false;
+    // Set when resumed from a checkpoint, where there is no gzip header.
+    bool m_rawDeflate = false;
+    bool m_newMember = false;
+    bool m_ended = false;
+};
+
+#endif
+
+#if defined(HAVE_ZSTD)
+
+// Seekable zstd decompression. The frames are independent, so the checkpoints are taken at the frame boundaries
+// and need no window. A file with a single frame can only be read from the beginning, but the ones written
+// with multiple frames (e.g. by pzstd or the seekable format) have random access.
+class ZstdDecoder : public DecoderImp
+{
+public:
+    ZstdDecoder(std::istream &raw, DecompressIndex &index) : DecoderImp(raw, index), m_ds(ZSTD_createDStream()) {}
+
+    ~ZstdDecoder() { ZSTD_freeDStream(m_ds); }
+
+    bool restart(const std::optional<DecompressCheckpoint> &checkpoint, std::string &window) override
+    {
+        if (m_ds == nullptr)
+        {
+            return false;
+        }
+
+        window.clear();
+        m_ended = false;
+        m_inPos = checkpoint.has_value() ? checkpoint->in : 0;
+        m_inBuf = {m_in.data(), 0, 0};
+        return !ZSTD_isError(ZSTD_DCtx_reset(m_ds, ZSTD_reset_session_only));
+    }
+
+    tp::UInt decode(char *out, tp::UInt outLen, tp::UInt outSize, tp::UInt outPos) override
+    {
+        ZSTD_outBuffer outBuf{out + outLen, outSize - outLen, 0};
+
+        while (!m_ended && (outBuf.pos < outBuf.size))
+        {
+            if (m_inBuf.pos == m_inBuf.size)
+            {
+                m_inBuf = {m_in.data(), readInput(), 0};
+                if (m_inBuf.size == 0)
+                {
+                    // The file may still be growing, so it's not the end yet.
+                    break;
+                }
+            }
+
+            const size_t res = ZSTD_decompressStream(m_ds, &outBuf, &m_inBuf);
+            if (ZSTD_isError(res))
+            {
+                LOG_ERR("Invalid zstd data at {}: {}", m_inPos - (m_inBuf.size - m_inBuf.pos), ZSTD_getErrorName(res));
+                m_ended = true;
+            }
+            else if (res == 0)
+            {
+                // A frame ends here, so the next one can be decompressed on its own.
+                const tp::UInt pos(outPos + outLen + outBuf.pos);
+                if (m_index.wants(pos))
+                {
+                    DecompressCheckpoint checkpoint;
+                    checkpoint.in = m_inPos - (m_inBuf.size - m_inBuf.pos);
+                    checkpoint.out = pos;
+                    m_index.add(std::move(checkpoint));
+                }
+            }
+        }
+
+        return outBuf.pos;
+    }
+
+private:
+    ZSTD_DStream *m_ds;
+    ZSTD_inBuffer m_inBuf{};
+    bool m_ended = false;
+};
+
+#endif
+
+Decompressor::Decompressor(std::istream &raw, Format format, std::shared_ptr<DecompressIndex> index)
+    : m_raw(raw),
+      m_index(index ? index : std::make_shared<DecompressIndex>()),
+      m_stream(this)
+{
+    switch (format)
+    {
+#if defined(HAVE_ZLIB)
+        case Format::Gzip:
+            m_imp = new GzipDecoder(raw, *m_index);
+            break;
+#endif
+#if defined(HAVE_ZSTD)
+        case Format::Zstd:
+            m_imp = new ZstdDecoder(raw, *m_index);
+            break;
+#endif
+        default:
+            break;
+    }
+
+    m_out.resize(g_windowSize + g_outSize);
+    if (!m_imp || !restart(0))
+    {
+        LOG_ERR("Cannot decompress {} data", formatName(format));
+        m_stream.setstate(std::ios::badbit);
+    }
+    resetGetArea(m_outPos);
+}
+
+Decompressor::~Decompressor()
+{
+    delete m_imp;
+}
+
+Decompressor::Format Decompressor::detect(std::istream &raw)
+{
+    unsigned char magic[4] = {};
+    raw.clear();
+    raw.seekg(0, std::ios::beg);
+    raw.read(reinterpret_cast<char *>(magic), sizeof(magic));
+    const auto readBytes = raw.gcount();
+    raw.clear();
+    raw.seekg(0, std::ios::beg);
+
+    if ((readBytes >= 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b))
+    {
+        return Format::Gzip;
+    }
+    if ((readBytes == 4) && (magic[0] == 0x28) && (magic[1] == 0xb5) && (magic[2] == 0x2f) && (magic[3] == 0xfd))
+    {
+        return Format::Zstd;
+    }
+    return Format::None;
+}
+
+bool Decompressor::isSupported(Format format)
+{
+    switch (format)
+    {
+#if defined(HAVE_ZLIB)
+        case Format::Gzip:
+            return true;
+#endif
+#if defined(HAVE_ZSTD)
+        case Format::Zstd:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+const char *Decompressor::formatName(Format format)
+{
+    switch (format)
+    {
+        case Format::Gzip:
+            return "gzip";
+        case Format::Zstd:
+            return "zstd";
+        default:
+            return "uncompressed";
+    }
+}
+
+Decompressor::int_type Decompressor::underflow()
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    const tp::UInt pos(m_outPos + (gptr() - eback()));
+    const bool decoded(m_imp && decodeMore());
+    resetGetArea(pos);
+    return decoded ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+}
+
+Decompressor::pos_type Decompressor::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if (dir == std::ios_base::cur)
+    {
+        const off_type pos(m_outPos + (gptr() - eback()));
+        // tellg() must not move anything.
+        return (off == 0) ? pos_type(pos) : seekpos(pos + off, which);
+    }
+    else if (dir == std::ios_base::end)
+    {
+        return seekpos(static_cast<off_type>(decodeToEnd()) + off, which);
+    }
+    return seekpos(off, which);
+}
+
+Decompressor::pos_type Decompressor::seekpos(pos_type pos, std::ios_base::openmode)
+{
+    const off_type offset(pos);
+    if (!m_imp || (offset < 0))
+    {
+        return pos_type(off_type(-1));
+    }
+
+    // Going backwards, or too far ahead, the decompression restarts from the nearest checkpoint.
+    const tp::UInt target(offset);
+    if ((target < m_outPos) || ((target > getEndPos()) && (m_index->findPos(target) > getEndPos())))
+    {
+        if (!restart(target))
+        {
+            return pos_type(off_type(-1));
+        }
+    }
+
+    while (target > getEndPos())
+    {
+        if (!decodeMore())
+        {
+            resetGetArea(getEndPos());
+            return pos_type(off_type(-1));
+        }
+    }
+
+    resetGetArea(target);
+    return pos;
+}
+
+bool Decompressor::decodeMore()
+{
+    // Only the window is kept when the buffer is full.
+    if (m_outLen == m_out.size())
+    {
+        std::memmove(m_out.data(), m_out.data() + m_outLen - g_windowSize, g_windowSize);
+        m_outPos += m_outLen - g_windowSize;
+        m_outLen = g_windowSize;
+    }
+
+    const tp::UInt decoded(m_imp->decode(m_out.data(), m_outLen, m_out.size(), m_outPos));
+    m_outLen += decoded;
+    return (decoded > 0);
+}
+
+bool Decompressor::restart(tp::UInt pos)
+{
+    const auto checkpoint = m_index->find(pos);
+    std::string window;
+    if (!m_imp->restart(checkpoint, window))
+    {
+        LOG_ERR("Cannot restart the decompression at {}", checkpoint.has_value() ? checkpoint->out : 0);
+        return false;
+    }
+
+    std::memcpy(m_out.data(), window.data(), window.size());
+    m_outLen = window.size();
+    m_outPos = (checkpoint.has_value() ? checkpoint->out : 0) - m_outLen;
+    return true;
+}
+
+tp::UInt Decompressor::decodeToEnd()
+{
+    m_raw.clear();
+    m_raw.seekg(0, std::ios::end);
+    const tp::UInt rawSize(std::max<std::streamoff>(m_raw.tellg(), 0));
+    if (const auto endPos = m_index->getEnd(rawSize); endPos.has_value())
+    {
+        return endPos.value();
+    }
+
+    if (!m_imp)
+    {
+        return 0;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // The size is only known by decompressing everything, which goes on from the furthest known point.
+    const tp::UInt lastPos(m_index->lastPos());
+    if ((lastPos > getEndPos()) && !restart(lastPos))
+    {
+        return getEndPos();
+    }
+    while (decodeMore())
+    {
+    }
+    resetGetArea(getEndPos());
+
+    const tp::UInt endPos(getEndPos());
+    m_index->setEnd(endPos, rawSize);
+    LOG_INF(
+        "Decompressed {} bytes into {} in {} ms, with {} checkpoints using {} KB",
+        rawSize,
+        endPos,
+        timer.elapsed(),
+        m_index->count(),
+        m_index->memorySize() / 1024);
+
+    return endPos;
+}
+
+void Decompressor::resetGetArea(tp::UInt pos)
+{
+    char *begin = m_out.data();
+    setg(begin, begin + (pos - m_outPos), begin + m_outLen);
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+class DecoderImp;
+class DecompressIndex;
+
+// Stream buffer over the uncompressed data of a gzip or zstd file, which allows random access to it.
+// The decoder state is saved in checkpoints while the data is decompressed, so seeking restarts the decompression
+// from the nearest checkpoint before the position, instead of from the beginning of the file.
+// All positions are in uncompressed coordinates.
+class Decompressor : private std::streambuf
+{
+public:
+    enum class Format
+    {
+        None,
+        Gzip,
+        Zstd
+    };
+
+    Decompressor(const Decompressor &) = delete;
+    Decompressor(Decompressor &&) = delete;
+    ~Decompressor();
+
+    // Detects the format by the magic bytes at the beginning of the stream.
+    static Format detect(std::istream &raw);
+    // Whether the support for the format was built.
+    static bool isSupported(Format format);
+    static const char *formatName(Format format);
+
+    std::istream &getStream() { return m_stream; }
+    // The checkpoints, which can be shared by other decompressors of the same file.
+    const std::shared_ptr<DecompressIndex> &getIndex() const { return m_index; }
+
+    using Ptr = std::unique_ptr<Decompressor>;
+    static Decompressor::Ptr make(std::istream &raw, Format format, std::shared_ptr<DecompressIndex> index = nullptr)
+    {
+        return Decompressor::Ptr(new Decompressor(raw, format, index));
+    }
+
+protected:
+    int_type underflow() override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+    Decompressor(std::istream &raw, Format format, std::shared_ptr<DecompressIndex> index);
+    bool decodeMore();
+    bool restart(tp::UInt pos);
+    tp::UInt decodeToEnd();
+    void resetGetArea(tp::UInt pos);
+    tp::UInt getEndPos() const { return m_outPos + m_outLen; }
+
+    std::istream &m_raw;
+    std::shared_ptr<DecompressIndex> m_index;
+    DecoderImp *m_imp = nullptr;
+    std::istream m_stream;
+    // The last decompressed data, which starts with the window required by the checkpoints.
+    std::string m_out;
+    // Uncompressed position of the first byte of m_out.
+    tp::UInt m_outPos = 0;
+    tp::UInt m_outLen = 0;
+};
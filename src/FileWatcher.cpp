@@ -0,0 +1,262 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "FileWatcher.h"
+#include <chrono>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif
+
+// Interval used when the changes cannot be notified.
+constexpr std::chrono::milliseconds g_pollInterval(500);
+
+// Identifies the file that currently has the name, to tell when another one took it.
+class FileIdentity
+{
+public:
+    FileIdentity(const std::string &fileName) : m_fileName(fileName) { checkReplaced(); }
+
+    // A missing file is not taken as replaced, since the caller notices it. The next file found with the name
+    // becomes the identified one.
+    bool checkReplaced()
+    {
+#if defined(_WIN32)
+        return false;
+#else
+        struct stat st;
+        if (::stat(m_fileName.c_str(), &st) != 0)
+        {
+            m_known = false;
+            return false;
+        }
+
+        const bool replaced = m_known && ((st.st_dev != m_dev) || (st.st_ino != m_ino));
+        m_known = true;
+        m_dev = st.st_dev;
+        m_ino = st.st_ino;
+        return replaced;
+#endif
+    }
+
+private:
+    std::string m_fileName;
+    bool m_known = false;
+    std::uint64_t m_dev = 0;
+    std::uint64_t m_ino = 0;
+};
+
+#if defined(__linux__)
+
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+
+// Even with inotify, the file is checked from time to time, as some file systems (e.g. NFS) don't notify
+// the changes made by other hosts.
+constexpr std::chrono::milliseconds g_eventDrivenPollInterval(5000);
+
+class FileWatcherImp
+{
+public:
+    FileWatcherImp(const std::string &fileName) : m_fileName(fileName), m_identity(fileName)
+    {
+        m_wakeUpFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        m_inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_inotifyFd == -1)
+        {
+            LOG_WAR("Cannot use inotify to watch '{}', polling it instead: {}", fileName, std::strerror(errno));
+            return;
+        }
+
+        std::string dirName(".");
+        if (const auto pos = fileName.find_last_of('/'); pos != std::string::npos)
+        {
+            dirName = (pos == 0) ? "/" : fileName.substr(0, pos);
+            m_baseName = fileName.substr(pos + 1);
+        }
+        else
+        {
+            m_baseName = fileName;
+        }
+
+        // The directory is watched to notice when the file is created, moved or removed.
+        m_dirWd = ::inotify_add_watch(
+            m_inotifyFd,
+            dirName.c_str(),
+            IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR);
+        addFileWatch();
+    }
+
+    ~FileWatcherImp()
+    {
+        if (m_inotifyFd != -1)
+        {
+            ::close(m_inotifyFd);
+        }
+        if (m_wakeUpFd != -1)
+        {
+            ::close(m_wakeUpFd);
+        }
+    }
+
+    bool waitImp()
+    {
+        if (m_fileWd == -1)
+        {
+            addFileWatch();
+        }
+
+        pollfd fds[2] = {{m_wakeUpFd, POLLIN, 0}, {m_inotifyFd, POLLIN, 0}};
+        const auto timeout = isEventDrivenImp() ? g_eventDrivenPollInterval : g_pollInterval;
+        if (::poll(fds, 2, timeout.count()) > 0)
+        {
+            if (fds[0].revents & POLLIN)
+            {
+                std::uint64_t value;
+                [[maybe_unused]] const auto res = ::read(m_wakeUpFd, &value, sizeof(value));
+            }
+            if (fds[1].revents & POLLIN)
+            {
+                readEvents();
+            }
+        }
+
+        return m_identity.checkReplaced();
+    }
+
+    void wakeUpImp()
+    {
+        const std::uint64_t value(1);
+        [[maybe_unused]] const auto res = ::write(m_wakeUpFd, &value, sizeof(value));
+    }
+
+    bool isEventDrivenImp() const { return (m_inotifyFd != -1) && ((m_fileWd != -1) || (m_dirWd != -1)); }
+
+private:
+    void addFileWatch()
+    {
+        if (m_inotifyFd != -1)
+        {
+            m_fileWd = ::inotify_add_watch(
+                m_inotifyFd,
+                m_fileName.c_str(),
+                IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+        }
+    }
+
+    void removeFileWatch()
+    {
+        if (m_fileWd != -1)
+        {
+            ::inotify_rm_watch(m_inotifyFd, m_fileWd);
+            m_fileWd = -1;
+        }
+    }
+
+    // Only drains the events, as the file is checked anyway after waking up. But the file watch is renewed when
+    // the watched inode no longer is the file with the given name.
+    void readEvents()
+    {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t len;
+        while ((len = ::read(m_inotifyFd, buffer, sizeof(buffer))) > 0)
+        {
+            for (ssize_t i = 0; i < len;)
+            {
+                const auto event = reinterpret_cast<const inotify_event *>(buffer + i);
+                if (event->wd == m_fileWd)
+                {
+                    if (event->mask & IN_IGNORED)
+                    {
+                        m_fileWd = -1;
+                    }
+                    else if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF))
+                    {
+                        removeFileWatch();
+                    }
+                }
+                else if ((event->wd == m_dirWd) && (event->len > 0) && (m_baseName == event->name))
+                {
+                    removeFileWatch();
+                }
+                i += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+
+    std::string m_fileName;
+    FileIdentity m_identity;
+    std::string m_baseName;
+    int m_wakeUpFd = -1;
+    int m_inotifyFd = -1;
+    int m_fileWd = -1;
+    int m_dirWd = -1;
+};
+
+#else
+
+#include <condition_variable>
+#include <mutex>
+
+class FileWatcherImp
+{
+public:
+    FileWatcherImp(const std::string &fileName) : m_identity(fileName) {}
+
+    bool waitImp()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, g_pollInterval, [this]() { return m_wakeUp; });
+            m_wakeUp = false;
+        }
+        return m_identity.checkReplaced();
+    }
+
+    void wakeUpImp()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_wakeUp = true;
+        }
+        m_cv.notify_all();
+    }
+
+    bool isEventDrivenImp() const { return false; }
+
+private:
+    FileIdentity m_identity;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_wakeUp = false;
+};
+
+#endif
+
+FileWatcher::FileWatcher(const std::string &fileName) : m_imp(new FileWatcherImp(fileName))
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    delete m_imp;
+}
+
+bool FileWatcher::wait()
+{
+    return m_imp->waitImp();
+}
+
+void FileWatcher::wakeUp()
+{
+    m_imp->wakeUpImp();
+}
+
+bool FileWatcher::isEventDriven() const
+{
+    return m_imp->isEventDrivenImp();
+}
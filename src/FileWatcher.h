@@ -0,0 +1,33 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+class FileWatcherImp;
+
+// Waits for changes on a file.
+// On Linux it's driven by inotify, watching the file and its directory, so a recreated file is noticed as well.
+// A replaced file is told apart by its device and inode, which are not checked on Windows.
+// Elsewhere, or when inotify is not available, it falls back to polling.
+class FileWatcher
+{
+public:
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher(FileWatcher &&) = delete;
+    ~FileWatcher();
+
+    // Blocks until the file may have changed, wakeUp() is called or the poll interval expires.
+    // Spurious returns are possible, so the caller must check the file. Returns true when another file took the
+    // name since the previous call, as done by the log rotations that rename the file and create a new one.
+    bool wait();
+    // Makes the current or the next call to wait() return. It can be called from any thread.
+    void wakeUp();
+    bool isEventDriven() const;
+
+    using Ptr = std::unique_ptr<FileWatcher>;
+    static FileWatcher::Ptr make(const std::string &fileName) { return FileWatcher::Ptr(new FileWatcher(fileName)); }
+
+private:
+    FileWatcher(const std::string &fileName);
+    FileWatcherImp *m_imp;
+};
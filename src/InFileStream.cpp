@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "InFileStream.h"
+#include "Decompressor.h"
 
 #if defined(__MINGW32__)
 
@@ -132,12 +133,37 @@ public:
 
 #endif
 
-InFileStream::InFileStream(const std::string &fileName) : m_imp(new InFileStreamImp(fileName))
+InFileStream::InFileStream(const std::string &fileName, std::shared_ptr<DecompressIndex> index)
+    : m_fileName(fileName),
+      m_imp(new InFileStreamImp(fileName))
 {
+    if (!m_imp->isOpenImp())
+    {
+        return;
+    }
+
+    const auto format = Decompressor::detect(m_imp->getStreamImp());
+    if (format == Decompressor::Format::None)
+    {
+        return;
+    }
+
+    if (Decompressor::isSupported(format))
+    {
+        m_decompressor = Decompressor::make(m_imp->getStreamImp(), format, index);
+    }
+    else
+    {
+        LOG_WAR(
+            "File '{}' is {} compressed, which is not supported by this build",
+            fileName,
+            Decompressor::formatName(format));
+    }
 }
 
 InFileStream::~InFileStream()
 {
+    m_decompressor.reset();
     delete m_imp;
 }
 
@@ -153,5 +179,15 @@ void InFileStream::close()
 
 std::istream &InFileStream::getStream()
 {
-    return m_imp->getStreamImp();
+    return m_decompressor ? m_decompressor->getStream() : m_imp->getStreamImp();
+}
+
+bool InFileStream::isCompressed() const
+{
+    return (m_decompressor != nullptr);
+}
+
+InFileStream::Ptr InFileStream::reopen() const
+{
+    return InFileStream::Ptr(new InFileStream(m_fileName, m_decompressor ? m_decompressor->getIndex() : nullptr));
 }
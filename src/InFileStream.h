@@ -4,7 +4,11 @@
 #pragma once
 
 class InFileStreamImp;
+class Decompressor;
+class DecompressIndex;
 
+// Input file stream that can be read while other processes write the file.
+// Compressed files (gzip, zstd) are detected and read as their uncompressed data.
 class InFileStream
 {
 public:
@@ -15,11 +19,16 @@ public:
     bool isOpen() const;
     void close();
     std::istream &getStream();
+    bool isCompressed() const;
 
     using Ptr = std::unique_ptr<InFileStream>;
     static InFileStream::Ptr make(const std::string &fileName) { return InFileStream::Ptr(new InFileStream(fileName)); }
+    // Opens the same file again. A compressed file shares the decompression checkpoints built by this stream.
+    InFileStream::Ptr reopen() const;
 
 private:
-    InFileStream(const std::string &fileName);
+    InFileStream(const std::string &fileName, std::shared_ptr<DecompressIndex> index = nullptr);
+    std::string m_fileName;
     InFileStreamImp *m_imp;
+    std::unique_ptr<Decompressor> m_decompressor;
 };
@@ -0,0 +1,205 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "LineBreaks.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define LINE_BREAKS_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+namespace utl
+{
+
+namespace
+{
+
+using ScanFunc = LineBreaksScan (*)(const char *, tp::UInt);
+
+LineBreaksScan scanScalar(const char *data, tp::UInt size)
+{
+    LineBreaksScan scan;
+    for (tp::UInt i = 0; i < size; ++i)
+    {
+        if (data[i] == '\n')
+        {
+            ++scan.count;
+            scan.last = data + i;
+        }
+    }
+    return scan;
+}
+
+#ifdef LINE_BREAKS_X86_64
+
+int highestBit(std::uint32_t mask)
+{
+    int idx(0);
+    while (mask >>= 1)
+    {
+        ++idx;
+    }
+    return idx;
+}
+
+// The comparison results (0 or -1 per byte) are subtracted from 8-bit counters, which can hold up to
+// 255 blocks before being summed into 64-bit counters with sad.
+constexpr tp::UInt g_maxBlocksPerSum(255);
+
+LineBreaksScan scanSse2(const char *data, tp::UInt size)
+{
+    const __m128i newLine = _mm_set1_epi8('\n');
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    const char *lastBlock = nullptr;
+    std::uint32_t lastMask(0);
+    tp::UInt i(0);
+
+    while (i + sizeof(__m128i) <= size)
+    {
+        __m128i counters = zero;
+        const tp::UInt blocks(std::min<tp::UInt>((size - i) / sizeof(__m128i), g_maxBlocksPerSum));
+        for (tp::UInt b = 0; b < blocks; ++b, i += sizeof(__m128i))
+        {
+            const __m128i eq =
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), newLine);
+            counters = _mm_sub_epi8(counters, eq);
+            if (const std::uint32_t mask = _mm_movemask_epi8(eq); mask != 0)
+            {
+                lastMask = mask;
+                lastBlock = data + i;
+            }
+        }
+        total = _mm_add_epi64(total, _mm_sad_epu8(counters, zero));
+    }
+
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), total);
+
+    LineBreaksScan scan = scanScalar(data + i, size - i);
+    scan.count += lanes[0] + lanes[1];
+    if ((scan.last == nullptr) && (lastBlock != nullptr))
+    {
+        scan.last = lastBlock + highestBit(lastMask);
+    }
+    return scan;
+}
+
+TARGET_AVX2 LineBreaksScan scanAvx2(const char *data, tp::UInt size)
+{
+    const __m256i newLine = _mm256_set1_epi8('\n');
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i total = zero;
+    const char *lastBlock = nullptr;
+    std::uint32_t lastMask(0);
+    tp::UInt i(0);
+
+    while (i + sizeof(__m256i) <= size)
+    {
+        __m256i counters = zero;
+        const tp::UInt blocks(std::min<tp::UInt>((size - i) / sizeof(__m256i), g_maxBlocksPerSum));
+        for (tp::UInt b = 0; b < blocks; ++b, i += sizeof(__m256i))
+        {
+            const __m256i eq =
+                _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), newLine);
+            counters = _mm256_sub_epi8(counters, eq);
+            if (const std::uint32_t mask = _mm256_movemask_epi8(eq); mask != 0)
+            {
+                lastMask = mask;
+                lastBlock = data + i;
+            }
+        }
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(counters, zero));
+    }
+
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), total);
+
+    LineBreaksScan scan = scanScalar(data + i, size - i);
+    scan.count += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    if ((scan.last == nullptr) && (lastBlock != nullptr))
+    {
+        scan.last = lastBlock + highestBit(lastMask);
+    }
+    return scan;
+}
+
+bool hasAvx2()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // The OS must save the AVX registers.
+    __cpuid(info, 1);
+    const bool osxsave((info[2] & (1 << 27)) != 0);
+    const bool avx((info[2] & (1 << 28)) != 0);
+    if (!osxsave || !avx || ((_xgetbv(0) & 0x6) != 0x6))
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return ((info[1] & (1 << 5)) != 0);
+#else
+    return false;
+#endif
+}
+
+#endif
+
+std::pair<ScanFunc, const char *> selectScanFunc()
+{
+#ifdef LINE_BREAKS_X86_64
+    if (hasAvx2())
+        return {scanAvx2, "AVX2"};
+    // SSE2 is part of x86-64.
+    return {scanSse2, "SSE2"};
+#else
+    return {scanScalar, "Scalar"};
+#endif
+}
+
+const std::pair<ScanFunc, const char *> &getScanFunc()
+{
+    static const auto scanFunc = selectScanFunc();
+    return scanFunc;
+}
+
+} // namespace
+
+LineBreaksScan scanLineBreaks(const char *data, tp::UInt size)
+{
+    return getScanFunc().first(data, size);
+}
+
+const char *lineBreaksScannerName()
+{
+    return getScanFunc().second;
+}
+
+std::vector<LineBreaksScanner> lineBreaksScanners()
+{
+    std::vector<LineBreaksScanner> scanners{{"Scalar", scanScalar}};
+#ifdef LINE_BREAKS_X86_64
+    scanners.push_back({"SSE2", scanSse2});
+    if (hasAvx2())
+        scanners.push_back({"AVX2", scanAvx2});
+#endif
+    return scanners;
+}
+
+} // namespace utl
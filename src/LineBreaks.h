@@ -0,0 +1,32 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+namespace utl
+{
+
+struct LineBreaksScan
+{
+    tp::UInt count = 0;
+    // Points to the last line break found, or nullptr if there is none.
+    const char *last = nullptr;
+};
+
+// Counts the line breaks in the data and finds the last one.
+// The implementation is chosen at runtime according to the CPU (AVX2, SSE2 or scalar).
+LineBreaksScan scanLineBreaks(const char *data, tp::UInt size);
+
+// Name of the implementation used by scanLineBreaks.
+const char *lineBreaksScannerName();
+
+struct LineBreaksScanner
+{
+    const char *name;
+    LineBreaksScan (*scan)(const char *data, tp::UInt size);
+};
+
+// All the implementations supported by the CPU, so they can be compared by the benchmarks.
+std::vector<LineBreaksScanner> lineBreaksScanners();
+
+} // namespace utl
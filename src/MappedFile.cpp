@@ -0,0 +1,119 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+
+// A mapped view prevents the writer process from truncating the file (ERROR_USER_MAPPED_FILE), which would
+// break log rotation. So the mapping is not provided on Windows and the callers fall back to InFileStream.
+class MappedFileImp
+{
+public:
+    MappedFileImp(const std::string &) {}
+
+    bool isOpenImp() const { return false; }
+    const char *dataImp() const { return nullptr; }
+    tp::UInt sizeImp() const { return 0; }
+    tp::SInt fileSizeImp() const { return -1; }
+};
+
+#else
+
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+class MappedFileImp
+{
+public:
+    MappedFileImp(const std::string &fileName)
+    {
+        m_fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_fd == -1)
+        {
+            return;
+        }
+
+        const auto fSize = fileSizeImp();
+        if (fSize <= 0)
+        {
+            return;
+        }
+
+        void *addr = ::mmap(nullptr, fSize, PROT_READ, MAP_SHARED, m_fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            LOG_ERR("Cannot map file '{}': {}", fileName, std::strerror(errno));
+            return;
+        }
+
+        m_data = static_cast<const char *>(addr);
+        m_size = fSize;
+    }
+
+    ~MappedFileImp()
+    {
+        if (m_data != nullptr)
+        {
+            ::munmap(const_cast<char *>(m_data), m_size);
+        }
+        if (m_fd != -1)
+        {
+            ::close(m_fd);
+        }
+    }
+
+    bool isOpenImp() const { return (m_data != nullptr); }
+    const char *dataImp() const { return m_data; }
+    tp::UInt sizeImp() const { return m_size; }
+
+    tp::SInt fileSizeImp() const
+    {
+        struct stat st;
+        if ((m_fd == -1) || (::fstat(m_fd, &st) != 0))
+        {
+            return -1;
+        }
+        return st.st_size;
+    }
+
+private:
+    int m_fd = -1;
+    const char *m_data = nullptr;
+    tp::UInt m_size = 0;
+};
+
+#endif
+
+MappedFile::MappedFile(const std::string &fileName) : m_imp(new MappedFileImp(fileName))
+{
+}
+
+MappedFile::~MappedFile()
+{
+    delete m_imp;
+}
+
+bool MappedFile::isOpen() const
+{
+    return m_imp->isOpenImp();
+}
+
+const char *MappedFile::data() const
+{
+    return m_imp->dataImp();
+}
+
+tp::UInt MappedFile::size() const
+{
+    return m_imp->sizeImp();
+}
+
+tp::SInt MappedFile::fileSize() const
+{
+    return m_imp->fileSizeImp();
+}
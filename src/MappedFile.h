@@ -0,0 +1,36 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include <string_view>
+
+class MappedFileImp;
+
+// Read-only memory mapping of a file snapshot.
+// The mapping covers the file size at the time it was created, so a growing file needs a new mapping
+// to reach the new bytes. It's shared, so the views given by it remain valid while someone holds the Ptr,
+// unless the file is truncated: the pages past the new end raise SIGBUS, so the views must be dropped as soon
+// as the file is seen shrinking.
+class MappedFile
+{
+public:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    ~MappedFile();
+
+    bool isOpen() const;
+    const char *data() const;
+    tp::UInt size() const;
+    // Current size of the file on disk, which may differ from the mapped size.
+    tp::SInt fileSize() const;
+    bool contains(tp::UInt pos, tp::UInt len) const { return isOpen() && (pos + len <= size()); }
+    std::string_view view(tp::UInt pos, tp::UInt len) const { return std::string_view(data() + pos, len); }
+
+    using Ptr = std::shared_ptr<MappedFile>;
+    static MappedFile::Ptr make(const std::string &fileName) { return MappedFile::Ptr(new MappedFile(fileName)); }
+
+private:
+    MappedFile(const std::string &fileName);
+    MappedFileImp *m_imp;
+};
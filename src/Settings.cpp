@@ -58,6 +58,7 @@ void Settings::initSettings()
     s.loadSingleInstance();
     s.loadHideUniqueTab();
     s.loadDefaultSearchType();
+    s.loadChunkCacheSize();
 
     loadTemplates();
 }
@@ -387,3 +388,19 @@ tp::SearchType Settings::getDefaultSearchType()
 {
     return inst().m_searchType;
 }
+
+void Settings::loadChunkCacheSize()
+{
+    m_chunkCacheSize = inst().m_settings->value("chunkCacheSize", 64).toULongLong();
+}
+
+void Settings::setChunkCacheSize(tp::UInt sizeMB)
+{
+    inst().m_settings->setValue("chunkCacheSize", static_cast<qulonglong>(sizeMB));
+    inst().loadChunkCacheSize();
+}
+
+tp::UInt Settings::getChunkCacheSize()
+{
+    return inst().m_chunkCacheSize;
+}
@@ -47,6 +47,9 @@ public:
     static void setDefaultSearchType(tp::SearchType searchType);
     static tp::SearchType getDefaultSearchType();
 
+    static void setChunkCacheSize(tp::UInt sizeMB);
+    static tp::UInt getChunkCacheSize();
+
 private:
     Settings() = default;
     static Settings &inst();
@@ -55,6 +58,7 @@ private:
     void loadSingleInstance();
     void loadHideUniqueTab();
     void loadDefaultSearchType();
+    void loadChunkCacheSize();
 
     QFont m_font;
     QDir m_settingsDir;
@@ -65,5 +69,6 @@ private:
     bool m_singleInstance;
     bool m_hideUniqueTab;
     tp::SearchType m_searchType;
+    tp::UInt m_chunkCacheSize;
     std::vector<FileConf::Ptr> m_templates;
 };
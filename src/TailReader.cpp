@@ -0,0 +1,106 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "TailReader.h"
+
+constexpr tp::UInt g_readAheadSize(1024 * 1024);
+
+TailReader::TailReader(const std::string &fileName) : m_ifs(InFileStream::make(fileName)), m_stream(this)
+{
+}
+
+bool TailReader::read(tp::UInt pos, tp::UInt maxBytes)
+{
+    if (!m_ifs->isOpen())
+    {
+        return false;
+    }
+
+    // The buffered data after pos is kept, which is usually the incomplete row left by the previous parsing.
+    if ((pos >= m_bufferPos) && (pos <= getEndPos()))
+    {
+        m_buffer.erase(0, pos - m_bufferPos);
+    }
+    else
+    {
+        m_buffer.clear();
+    }
+    m_bufferPos = pos;
+
+    auto &is = m_ifs->getStream();
+    if (m_filePos != getEndPos())
+    {
+        is.clear();
+        is.seekg(getEndPos(), std::ios::beg);
+        ++m_seekCalls;
+        m_filePos = getEndPos();
+    }
+
+    bool reachedEnd(false);
+    while (m_buffer.size() <= maxBytes)
+    {
+        const tp::UInt oldSize(m_buffer.size());
+        m_buffer.resize(oldSize + g_readAheadSize);
+
+        // The eof from the previous read is cleared, so the data appended since then can be read.
+        is.clear();
+        is.read(m_buffer.data() + oldSize, g_readAheadSize);
+        const tp::UInt readBytes(is.gcount());
+        ++m_readCalls;
+        m_readBytes += readBytes;
+        m_buffer.resize(oldSize + readBytes);
+        m_filePos = m_filePos.value() + readBytes;
+
+        if (readBytes < g_readAheadSize)
+        {
+            reachedEnd = true;
+#if defined(_MSC_VER)
+            // The FILE used by the stream keeps its EOF indicator until it's repositioned.
+            m_filePos.reset();
+#endif
+            break;
+        }
+    }
+
+    resetGetArea(pos);
+    m_stream.clear();
+    return reachedEnd;
+}
+
+TailReader::int_type TailReader::underflow()
+{
+    // The stream ends with the buffered data.
+    return traits_type::eof();
+}
+
+TailReader::pos_type TailReader::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    off_type pos(off);
+    if (dir == std::ios_base::cur)
+    {
+        pos += m_bufferPos + (gptr() - eback());
+    }
+    else if (dir == std::ios_base::end)
+    {
+        pos += getEndPos();
+    }
+    return seekpos(pos, which);
+}
+
+TailReader::pos_type TailReader::seekpos(pos_type pos, std::ios_base::openmode)
+{
+    const off_type offset(pos);
+    if ((offset < static_cast<off_type>(m_bufferPos)) || (offset > static_cast<off_type>(getEndPos())))
+    {
+        return pos_type(off_type(-1));
+    }
+    resetGetArea(offset);
+    return pos;
+}
+
+void TailReader::resetGetArea(tp::UInt pos)
+{
+    char *begin = m_buffer.data();
+    setg(begin, begin + (pos - m_bufferPos), begin + m_buffer.size());
+}
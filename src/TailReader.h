@@ -0,0 +1,51 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include "InFileStream.h"
+
+// Long-lived reader for the data appended to a file.
+// It keeps the file open and reads sequentially into its own buffer, which is exposed as a stream positioned
+// in file coordinates. The stream ends where the available data ends, so no file size query is needed.
+class TailReader : private std::streambuf
+{
+public:
+    TailReader(const TailReader &) = delete;
+    TailReader(TailReader &&) = delete;
+
+    // Reads the data available from pos, keeping the buffered data after it.
+    // Returns false if the end was not reached after buffering maxBytes, in which case the caller should read
+    // the data otherwise.
+    bool read(tp::UInt pos, tp::UInt maxBytes);
+    std::istream &getStream() { return m_stream; }
+    // Position of the end of the buffered data.
+    tp::UInt getEndPos() const { return m_bufferPos + m_buffer.size(); }
+
+    tp::UInt getReadCalls() const { return m_readCalls; }
+    tp::UInt getSeekCalls() const { return m_seekCalls; }
+    tp::UInt getReadBytes() const { return m_readBytes; }
+
+    using Ptr = std::unique_ptr<TailReader>;
+    static TailReader::Ptr make(const std::string &fileName) { return TailReader::Ptr(new TailReader(fileName)); }
+
+protected:
+    int_type underflow() override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+    TailReader(const std::string &fileName);
+    void resetGetArea(tp::UInt pos);
+
+    InFileStream::Ptr m_ifs;
+    std::istream m_stream;
+    std::string m_buffer;
+    // File position of the first buffered byte.
+    tp::UInt m_bufferPos = 0;
+    // File position where the next read from m_ifs happens.
+    std::optional<tp::UInt> m_filePos;
+    tp::UInt m_readCalls = 0;
+    tp::UInt m_seekCalls = 0;
+    tp::UInt m_readBytes = 0;
+};
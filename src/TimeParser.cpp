@@ -0,0 +1,462 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "TimeParser.h"
+#include <array>
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+
+constexpr std::int64_t g_nsecsPerMSec(1000000);
+
+const std::array<std::string_view, 12> g_monthNames{
+    "January",
+    "February",
+    "March",
+    "April",
+    "May",
+    "June",
+    "July",
+    "August",
+    "September",
+    "October",
+    "November",
+    "December"};
+
+const std::array<std::string_view, 7> g_dayNames{
+    "Monday",
+    "Tuesday",
+    "Wednesday",
+    "Thursday",
+    "Friday",
+    "Saturday",
+    "Sunday"};
+
+bool isDigit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+bool startsWithNoCase(std::string_view text, std::string_view prefix)
+{
+    const auto toLower = [](char c) { return ((c >= 'A') && (c <= 'Z')) ? static_cast<char>(c + ('a' - 'A')) : c; };
+    return (text.size() >= prefix.size()) &&
+           std::equal(
+               prefix.begin(),
+               prefix.end(),
+               text.begin(),
+               [&toLower](char lhs, char rhs) { return (toLower(lhs) == toLower(rhs)); });
+}
+
+// Consumes the long or the short name, returning its index.
+template <std::size_t N>
+std::optional<int> parseName(std::string_view &text, const std::array<std::string_view, N> &names, bool longName)
+{
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+        const std::string_view name(longName ? names[i] : names[i].substr(0, 3));
+        if (startsWithNoCase(text, name))
+        {
+            text.remove_prefix(name.size());
+            return static_cast<int>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+int daysInMonth(int year, int month)
+{
+    static const std::array<int, 12> days{31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap(((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0)));
+    return ((month == 2) && leap) ? 29 : days[month - 1];
+}
+
+// Milliseconds since the epoch at the start of the hour in local time, as QDateTime converts it.
+// The rows are mostly in order, so the last hour converted by each thread is kept.
+std::optional<std::int64_t> localHourToMSecs(int year, int month, int day, int hour)
+{
+    thread_local std::int64_t lastKey(-1);
+    thread_local std::optional<std::int64_t> lastMSecs;
+
+    const std::int64_t key((((((static_cast<std::int64_t>(year) * 16) + month) * 32) + day) * 24) + hour);
+    if (key != lastKey)
+    {
+        const QDateTime dateTime(QDate(year, month, day), QTime(hour, 0));
+        lastMSecs = dateTime.isValid() ? std::optional<std::int64_t>(dateTime.toMSecsSinceEpoch()) : std::nullopt;
+        lastKey = key;
+    }
+    return lastMSecs;
+}
+
+} // namespace
+
+TimeParser::TimeParser(const std::string &format)
+{
+    setFormat(format);
+}
+
+void TimeParser::setFormat(const std::string &format)
+{
+    m_format = format;
+    m_qtFormat = QString::fromStdString(format);
+    m_epochUnit = 0;
+
+    if (format == "SECONDS")
+    {
+        m_epochUnit = 1000 * g_nsecsPerMSec;
+    }
+    else if (format == "MILLISECONDS")
+    {
+        m_epochUnit = g_nsecsPerMSec;
+    }
+
+    m_compiled = (m_epochUnit != 0) || compile();
+    if (!m_compiled)
+    {
+        m_steps.clear();
+        LOG_INF("Time format '{}' is parsed by QDateTime", format);
+    }
+}
+
+bool TimeParser::compile()
+{
+    m_steps.clear();
+    m_hasNames = false;
+    if (m_format.empty())
+    {
+        return false;
+    }
+
+    const auto addLiteral = [this](char c)
+    {
+        if (m_steps.empty() || (m_steps.back().field != Field::Literal))
+        {
+            m_steps.emplace_back();
+        }
+        m_steps.back().literal += c;
+    };
+    const auto addField = [this](Field field, tp::UInt minDigits = 0, tp::UInt maxDigits = 0)
+    {
+        auto &step = m_steps.emplace_back();
+        step.field = field;
+        step.minDigits = minDigits;
+        step.maxDigits = maxDigits;
+    };
+
+    // The hours of 'h' are in 12-hour clock only when the format has AM/PM.
+    std::vector<tp::UInt> hourSteps;
+    bool hasAmPm(false);
+
+    for (tp::UInt i = 0; i < m_format.size();)
+    {
+        const char c(m_format[i]);
+        tp::UInt count(1);
+        while (((i + count) < m_format.size()) && (m_format[i + count] == c))
+        {
+            ++count;
+        }
+
+        switch (c)
+        {
+        case '\'':
+            if (count > 1)
+            {
+                // Two quotes are a quote.
+                addLiteral('\'');
+                i += 2;
+                continue;
+            }
+            // Quoted text, where two quotes are a quote as well.
+            for (++i; i < m_format.size(); ++i)
+            {
+                if (m_format[i] == '\'')
+                {
+                    if (((i + 1) < m_format.size()) && (m_format[i + 1] == '\''))
+                    {
+                        addLiteral('\'');
+                        ++i;
+                        continue;
+                    }
+                    break;
+                }
+                addLiteral(m_format[i]);
+            }
+            if (i == m_format.size())
+            {
+                return false;
+            }
+            ++i;
+            continue;
+        case 'd':
+        case 'M':
+            if (count > 4)
+            {
+                return false;
+            }
+            if (count > 2)
+            {
+                if (c == 'd')
+                {
+                    addField((count == 4) ? Field::LongDayName : Field::ShortDayName);
+                }
+                else
+                {
+                    addField((count == 4) ? Field::LongMonthName : Field::ShortMonthName);
+                }
+                m_hasNames = true;
+            }
+            else
+            {
+                addField((c == 'd') ? Field::Day : Field::Month, count, 2);
+            }
+            break;
+        case 'y':
+            if ((count != 2) && (count != 4))
+            {
+                return false;
+            }
+            addField((count == 4) ? Field::Year : Field::ShortYear, count, count);
+            break;
+        case 'h':
+        case 'H':
+        case 'm':
+        case 's':
+            if (count > 2)
+            {
+                return false;
+            }
+            if (c == 'h')
+            {
+                hourSteps.push_back(m_steps.size());
+            }
+            addField(((c == 'h') || (c == 'H')) ? Field::Hour : ((c == 'm') ? Field::Minute : Field::Second), count, 2);
+            break;
+        case 'z':
+            if (count == 3)
+            {
+                addField(Field::Millisecond, 3, 3);
+            }
+            else if (count == 1)
+            {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+                // Qt 6 reads it as the fraction of the second.
+                addField(Field::Fraction, 1, 3);
+#else
+                addField(Field::Millisecond, 1, 3);
+#endif
+            }
+            else
+            {
+                return false;
+            }
+            break;
+        case 'A':
+        case 'a':
+            if (count > 1)
+            {
+                return false;
+            }
+            if (((i + 1) < m_format.size()) && ((m_format[i + 1] == 'P') || (m_format[i + 1] == 'p')))
+            {
+                ++i;
+            }
+            addField(Field::AmPm);
+            hasAmPm = true;
+            break;
+        case 't':
+            return false;
+        default:
+            for (tp::UInt j = 0; j < count; ++j)
+            {
+                addLiteral(c);
+            }
+            break;
+        }
+        i += count;
+    }
+
+    if (hasAmPm)
+    {
+        for (const auto step : hourSteps)
+        {
+            m_steps[step].field = Field::Hour12;
+        }
+    }
+    return true;
+}
+
+std::optional<std::int64_t> TimeParser::parse(std::string_view text) const
+{
+    if (m_epochUnit != 0)
+    {
+        while (!text.empty() && ((text.front() == ' ') || (text.front() == '\t')))
+        {
+            text.remove_prefix(1);
+        }
+        if ((text.size() > 1) && (text.front() == '+'))
+        {
+            text.remove_prefix(1);
+        }
+
+        std::int64_t value(0);
+        const auto res = std::from_chars(text.data(), text.data() + text.size(), value);
+        if ((res.ec != std::errc()) || (res.ptr != (text.data() + text.size())))
+        {
+            return std::nullopt;
+        }
+        return value * m_epochUnit;
+    }
+
+    if (!m_compiled)
+    {
+        return parseByQt(text);
+    }
+
+    const auto value = parseCompiled(text);
+    return (!value.has_value() && m_hasNames) ? parseByQt(text) : value;
+}
+
+std::optional<std::int64_t> TimeParser::parseCompiled(std::string_view text) const
+{
+    // Same defaults as QDateTime::fromString.
+    int year(1900);
+    int month(1);
+    int day(1);
+    int hour(0);
+    int minute(0);
+    int second(0);
+    int msec(0);
+    std::optional<bool> pm;
+
+    for (const auto &step : m_steps)
+    {
+        if (step.field == Field::Literal)
+        {
+            if ((text.size() < step.literal.size()) ||
+                (std::memcmp(text.data(), step.literal.data(), step.literal.size()) != 0))
+            {
+                return std::nullopt;
+            }
+            text.remove_prefix(step.literal.size());
+            continue;
+        }
+
+        if ((step.field == Field::ShortMonthName) || (step.field == Field::LongMonthName))
+        {
+            const auto idx = parseName(text, g_monthNames, step.field == Field::LongMonthName);
+            if (!idx.has_value())
+            {
+                return std::nullopt;
+            }
+            month = idx.value() + 1;
+            continue;
+        }
+
+        if ((step.field == Field::ShortDayName) || (step.field == Field::LongDayName))
+        {
+            // The name of the day is only checked, as the date is set by the other fields.
+            if (!parseName(text, g_dayNames, step.field == Field::LongDayName).has_value())
+            {
+                return std::nullopt;
+            }
+            continue;
+        }
+
+        if (step.field == Field::AmPm)
+        {
+            if (startsWithNoCase(text, "AM") || startsWithNoCase(text, "PM"))
+            {
+                pm = ((text[0] == 'P') || (text[0] == 'p'));
+                text.remove_prefix(2);
+                continue;
+            }
+            return std::nullopt;
+        }
+
+        int value(0);
+        tp::UInt digits(0);
+        for (; (digits < step.maxDigits) && (digits < text.size()) && isDigit(text[digits]); ++digits)
+        {
+            value = (value * 10) + (text[digits] - '0');
+        }
+        if (digits < step.minDigits)
+        {
+            return std::nullopt;
+        }
+        text.remove_prefix(digits);
+
+        switch (step.field)
+        {
+        case Field::Year:
+            year = value;
+            break;
+        case Field::ShortYear:
+            year = 1900 + value;
+            break;
+        case Field::Month:
+            month = value;
+            break;
+        case Field::Day:
+            day = value;
+            break;
+        case Field::Hour:
+        case Field::Hour12:
+            hour = value;
+            break;
+        case Field::Minute:
+            minute = value;
+            break;
+        case Field::Second:
+            second = value;
+            break;
+        case Field::Millisecond:
+            msec = value;
+            break;
+        case Field::Fraction:
+            msec = value * ((digits == 1) ? 100 : ((digits == 2) ? 10 : 1));
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!text.empty())
+    {
+        return std::nullopt;
+    }
+
+    if (pm.has_value())
+    {
+        if ((hour < 1) || (hour > 12))
+        {
+            return std::nullopt;
+        }
+        hour = (hour % 12) + (pm.value() ? 12 : 0);
+    }
+
+    if ((month < 1) || (month > 12) || (day < 1) || (day > daysInMonth(year, month)) || (hour > 23) ||
+        (minute > 59) || (second > 59))
+    {
+        return std::nullopt;
+    }
+
+    const auto hourMSecs = localHourToMSecs(year, month, day, hour);
+    if (!hourMSecs.has_value())
+    {
+        return std::nullopt;
+    }
+    return (hourMSecs.value() + (((minute * 60) + second) * 1000) + msec) * g_nsecsPerMSec;
+}
+
+std::optional<std::int64_t> TimeParser::parseByQt(std::string_view text) const
+{
+    const auto dateTime = QDateTime::fromString(QString::fromUtf8(text.data(), text.size()), m_qtFormat);
+    if (!dateTime.isValid())
+    {
+        return std::nullopt;
+    }
+    return dateTime.toMSecsSinceEpoch() * g_nsecsPerMSec;
+}
@@ -0,0 +1,61 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+// Parser of the timestamps of a Time column into nanoseconds since the epoch.
+// The Qt format of the column is compiled once into a sequence of fields and literals, which are parsed straight
+// from the utf-8 text, with the same results as QDateTime::fromString. The formats with tokens that are not
+// supported by the compiled parser, like the time zones, are parsed by QDateTime.
+class TimeParser
+{
+public:
+    TimeParser(const std::string &format = std::string());
+    void setFormat(const std::string &format);
+    const std::string &getFormat() const { return m_format; }
+    // Whether the format is parsed without QDateTime.
+    bool isCompiled() const { return m_compiled; }
+    std::optional<std::int64_t> parse(std::string_view text) const;
+
+private:
+    enum class Field
+    {
+        Literal,
+        Year,
+        ShortYear,
+        Month,
+        ShortMonthName,
+        LongMonthName,
+        Day,
+        ShortDayName,
+        LongDayName,
+        Hour,
+        Hour12,
+        Minute,
+        Second,
+        Millisecond,
+        Fraction,
+        AmPm
+    };
+
+    struct Step
+    {
+        Field field = Field::Literal;
+        tp::UInt minDigits = 0;
+        tp::UInt maxDigits = 0;
+        std::string literal;
+    };
+
+    bool compile();
+    std::optional<std::int64_t> parseCompiled(std::string_view text) const;
+    std::optional<std::int64_t> parseByQt(std::string_view text) const;
+
+    std::string m_format;
+    QString m_qtFormat;
+    std::vector<Step> m_steps;
+    bool m_compiled = false;
+    // The names are compared in English, so the texts failing with them are parsed by QDateTime as well.
+    bool m_hasNames = false;
+    // The SECONDS and MILLISECONDS formats are numbers since the epoch.
+    std::int64_t m_epochUnit = 0;
+};
@@ -58,7 +58,7 @@ std::vector<std::string> split(const std::string &str, const std::string &delim)
     return res;
 }
 
-std::string toUpper(const std::string &text)
+std::string toUpper(std::string_view text)
 {
     // Way more farter, but works only for ascii characters.
     // std::string res(text);
@@ -85,11 +85,10 @@ QString elideLeft(const std::string &str, tp::UInt maxSize)
 
 QVariant toVariant(const tp::Column& column, const QString& text)
 {
-    QVariant v;
     switch (column.type)
     {
     case tp::ColumnType::Int:
-        v = text.toLongLong();
+        return text.toLongLong();
     case tp::ColumnType::UInt:
         return text.toULongLong();
     case tp::ColumnType::Time:
@@ -13,4 +13,54 @@ Highlighter::Highlighter(const tp::HighlighterParam& param) : m_param(param)
 bool Highlighter::matchInRow(const tp::RowData &rowData) const
 {
     return m_matcher.matchInRow(rowData);
-}
\ No newline at end of file
+}
+
+void Highlighters::setParams(const tp::HighlighterParams &params)
+{
+    m_highlighters.clear();
+    m_subStrings.clear();
+    const auto subStringCount = std::count_if(
+        params.begin(),
+        params.end(),
+        [](const tp::HighlighterParam &param) { return SubStringSet::canAdd(param.searchParam); });
+    for (tp::UInt i = 0; i < params.size(); ++i)
+    {
+        m_highlighters.emplace_back(params[i]);
+        if ((static_cast<tp::UInt>(subStringCount) >= AhoCorasick::s_minPatterns) &&
+            SubStringSet::canAdd(params[i].searchParam))
+        {
+            m_subStrings.add(i, params[i].searchParam);
+        }
+    }
+    m_subStrings.build();
+    m_found.assign(m_highlighters.size(), std::nullopt);
+}
+
+const Highlighter *Highlighters::findInRow(const tp::RowData &rowData) const
+{
+    if (!m_subStrings.empty())
+    {
+        m_subStrings.findInRow(rowData, m_found);
+    }
+
+    for (tp::UInt i = 0; i < m_highlighters.size(); ++i)
+    {
+        const auto &highlighter = m_highlighters[i];
+        const auto &param = highlighter.getSearchParam();
+        // A column out of the row is left to the matcher, which reports it.
+        const bool inRow(!param.column.has_value() || (static_cast<tp::UInt>(param.column->idx) < rowData.size()));
+        if (m_found[i].has_value() && inRow)
+        {
+            if (m_found[i].value() != param.flags.has(tp::SearchFlag::NotOperator))
+            {
+                return &highlighter;
+            }
+        }
+        else if (highlighter.matchInRow(rowData))
+        {
+            return &highlighter;
+        }
+    }
+
+    return nullptr;
+}
@@ -12,8 +12,23 @@ public:
     bool matchInRow(const tp::RowData &rowData) const;
     QColor getTextColor() const { return m_param.color.fg; }
     QColor getBgColor() const { return m_param.color.bg; }
+    const tp::SearchParam &getSearchParam() const { return m_param.searchParam; }
 
 private:
     tp::HighlighterParam m_param;
     Matcher m_matcher;
 };
+
+// The highlighters of a template, where the first one matching a row is applied to it.
+// When there are many substring ones, they are all found in a single pass over the row.
+class Highlighters
+{
+public:
+    void setParams(const tp::HighlighterParams &params);
+    const Highlighter *findInRow(const tp::RowData &rowData) const;
+
+private:
+    std::vector<Highlighter> m_highlighters;
+    SubStringSet m_subStrings;
+    mutable std::vector<std::optional<bool>> m_found;
+};
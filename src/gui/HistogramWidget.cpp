@@ -0,0 +1,161 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "HistogramWidget.h"
+#include "Style.h"
+#include <QPainter>
+#include <QMouseEvent>
+
+HistogramWidget::HistogramWidget(QWidget *parent) : QWidget(parent)
+{
+    setMouseTracking(true);
+    setMinimumHeight(Style::getTextHeight(true) * 4);
+    setMaximumHeight(Style::getTextHeight(true) * 6);
+}
+
+void HistogramWidget::setHistogram(Histogram::Ptr histogram)
+{
+    m_histogram = histogram;
+    m_maxCount = 0;
+    for (const auto &bucket : m_histogram->buckets)
+    {
+        m_maxCount = std::max(m_maxCount, bucket.count);
+    }
+    m_hoveredBucket = std::nullopt;
+    update();
+}
+
+void HistogramWidget::clear()
+{
+    m_histogram.reset();
+    m_maxCount = 0;
+    m_hoveredBucket = std::nullopt;
+    update();
+}
+
+QRect HistogramWidget::getBarsRect() const
+{
+    // The summary is written above the bars.
+    const int top(Style::getTextHeight(true));
+    return QRect(0, top, width(), height() - top);
+}
+
+std::optional<tp::UInt> HistogramWidget::getBucketAt(const QPoint &pos) const
+{
+    const QRect barsRect(getBarsRect());
+    if (!m_histogram || m_histogram->buckets.empty() || !barsRect.contains(pos))
+    {
+        return std::nullopt;
+    }
+
+    const tp::UInt bucket(((pos.x() - barsRect.left()) * m_histogram->buckets.size()) / barsRect.width());
+    return std::min<tp::UInt>(bucket, m_histogram->buckets.size() - 1);
+}
+
+QString HistogramWidget::getBucketText(tp::UInt bucket) const
+{
+    const auto &histogram = *m_histogram;
+    const std::int64_t start(histogram.start + (static_cast<std::int64_t>(bucket) * histogram.bucketSize));
+    const std::int64_t end(start + histogram.bucketSize);
+    const tp::UInt count(histogram.buckets[bucket].count);
+
+    if (histogram.byTime)
+    {
+        constexpr std::int64_t nsecsPerMSec(1000000);
+        const QString format("yyyy-MM-dd hh:mm:ss");
+        return tr("%1 to %2: %3 rows")
+            .arg(QDateTime::fromMSecsSinceEpoch(start / nsecsPerMSec).toString(format))
+            .arg(QDateTime::fromMSecsSinceEpoch(end / nsecsPerMSec).toString(format))
+            .arg(count);
+    }
+    return tr("Rows %1 to %2: %3 rows").arg(start + 1).arg(end).arg(count);
+}
+
+QString HistogramWidget::getSummaryText() const
+{
+    if (!m_histogram)
+    {
+        return QString();
+    }
+
+    QString text(tr("%1 rows matched").arg(m_histogram->count));
+    if (m_histogram->untimedCount > 0)
+    {
+        text.append(tr(", %1 without time").arg(m_histogram->untimedCount));
+    }
+    if (m_hoveredBucket.has_value())
+    {
+        text.append(QString(" - %1").arg(getBucketText(m_hoveredBucket.value())));
+    }
+    return text;
+}
+
+void HistogramWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Style::getTextAreaColor().bg);
+    if (!m_histogram)
+    {
+        return;
+    }
+
+    const tp::SInt padding(Style::getTextPadding());
+    painter.setFont(Style::getFont());
+    painter.setPen(Style::getTextAreaColor().fg);
+    painter.drawText(
+        QRect(padding, 0, width() - (2 * padding), Style::getTextHeight(true)),
+        Qt::AlignLeft | Qt::AlignVCenter,
+        Style::getElidedText(getSummaryText(), width() - (2 * padding), Qt::ElideRight));
+
+    const QRect barsRect(getBarsRect());
+    const auto &buckets = m_histogram->buckets;
+    if (buckets.empty() || (m_maxCount == 0))
+    {
+        return;
+    }
+
+    for (tp::UInt i = 0; i < buckets.size(); ++i)
+    {
+        if (buckets[i].count == 0)
+        {
+            continue;
+        }
+
+        // A bucket with any row has at least one pixel, so it's not lost among the larger ones.
+        const int left(barsRect.left() + static_cast<int>((i * barsRect.width()) / buckets.size()));
+        const int right(barsRect.left() + static_cast<int>(((i + 1) * barsRect.width()) / buckets.size()));
+        const int barHeight(std::max<int>(1, (buckets[i].count * barsRect.height()) / m_maxCount));
+        const QRect bar(left, barsRect.bottom() - barHeight + 1, std::max(1, right - left - 1), barHeight);
+        const bool hovered(m_hoveredBucket.has_value() && (m_hoveredBucket.value() == i));
+        painter.fillRect(bar, hovered ? Style::getSelectedColor().bg : Style::getScrollBarColor().fg);
+    }
+}
+
+void HistogramWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    const auto bucket = getBucketAt(event->pos());
+    if (bucket != m_hoveredBucket)
+    {
+        m_hoveredBucket = bucket;
+        update();
+    }
+}
+
+void HistogramWidget::mousePressEvent(QMouseEvent *event)
+{
+    const auto bucket = getBucketAt(event->pos());
+    if ((event->button() == Qt::LeftButton) && bucket.has_value() && (m_histogram->buckets[bucket.value()].count > 0))
+    {
+        emit rowSelected(m_histogram->buckets[bucket.value()].firstRow);
+    }
+}
+
+void HistogramWidget::leaveEvent(QEvent *)
+{
+    if (m_hoveredBucket.has_value())
+    {
+        m_hoveredBucket = std::nullopt;
+        update();
+    }
+}
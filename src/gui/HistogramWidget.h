@@ -0,0 +1,38 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include "Histogram.h"
+#include <QWidget>
+
+// Bars of the rows counted in each bucket of a histogram. Hovering a bar shows its bucket and count, and clicking
+// it selects the first row counted in it.
+class HistogramWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    HistogramWidget(QWidget *parent = nullptr);
+    void setHistogram(Histogram::Ptr histogram);
+    void clear();
+
+signals:
+    void rowSelected(tp::SInt row);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+
+private:
+    QRect getBarsRect() const;
+    std::optional<tp::UInt> getBucketAt(const QPoint &pos) const;
+    QString getBucketText(tp::UInt bucket) const;
+    QString getSummaryText() const;
+
+    Histogram::Ptr m_histogram;
+    tp::UInt m_maxCount = 0;
+    std::optional<tp::UInt> m_hoveredBucket;
+};
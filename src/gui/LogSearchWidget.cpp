@@ -10,6 +10,7 @@
 #include "ProxyModel.h"
 #include "LongScrollBar.h"
 #include "ProgressLabel.h"
+#include "HistogramWidget.h"
 #include "Style.h"
 #include <QTableView>
 #include <QVBoxLayout>
@@ -49,7 +50,20 @@ LogSearchWidget::LogSearchWidget(FileConf::Ptr conf, LogViewWidget *mainLog, Bas
     btnExec->setFocusPolicy(Qt::NoFocus);
     btnExec->setDefaultAction(m_actExec);
 
+    QToolButton *btnFindPrev = new QToolButton(this);
+    btnFindPrev->setFocusPolicy(Qt::NoFocus);
+    btnFindPrev->setDefaultAction(m_actFindPrev);
+
+    QToolButton *btnFindNext = new QToolButton(this);
+    btnFindNext->setFocusPolicy(Qt::NoFocus);
+    btnFindNext->setDefaultAction(m_actFindNext);
+
+    QToolButton *btnCount = new QToolButton(this);
+    btnCount->setFocusPolicy(Qt::NoFocus);
+    btnCount->setDefaultAction(m_actCount);
+
     m_prlSearching = new ProgressLabel(this);
+    m_prlCounting = new ProgressLabel(this);
 
     m_proxyModel = new ProxyModel(m_sourceModel);
 
@@ -59,11 +73,19 @@ LogSearchWidget::LogSearchWidget(FileConf::Ptr conf, LogViewWidget *mainLog, Bas
     hLayout->addWidget(btnClear);
     hLayout->addWidget(btnSyncMarks);
     hLayout->addWidget(btnExec);
+    hLayout->addWidget(btnFindPrev);
+    hLayout->addWidget(btnFindNext);
+    hLayout->addWidget(btnCount);
     hLayout->addWidget(m_prlSearching);
+    hLayout->addWidget(m_prlCounting);
     hLayout->addWidget(btnAddSearchParam);
 
     m_searchResults = new LogViewWidget(m_proxyModel, mainLog->getMarkedTexts(), this);
 
+    // Shown only with the counts of a search.
+    m_histogram = new HistogramWidget(this);
+    m_histogram->hide();
+
     m_searchParamsLayout = new QVBoxLayout();
     m_searchParamsLayout->setContentsMargins(2, 2, 2, 2);
     m_searchParamsLayout->setSpacing(2);
@@ -71,6 +93,7 @@ LogSearchWidget::LogSearchWidget(FileConf::Ptr conf, LogViewWidget *mainLog, Bas
     QVBoxLayout *vLayout = new QVBoxLayout();
     vLayout->addLayout(m_searchParamsLayout);
     vLayout->addLayout(hLayout);
+    vLayout->addWidget(m_histogram);
     vLayout->addWidget(m_searchResults);
 
     translateUi();
@@ -119,6 +142,21 @@ void LogSearchWidget::createActions()
     m_actSyncMarks = new QAction(this);
 
     m_actExec = new QAction(this);
+
+    // The shortcuts work from the main log as well, which is where the rows found are selected.
+    m_actFindPrev = new QAction(this);
+    m_actFindPrev->setShortcut(Qt::SHIFT | Qt::Key_F3);
+    m_actFindPrev->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    addAction(m_actFindPrev);
+    m_mainLog->addAction(m_actFindPrev);
+
+    m_actFindNext = new QAction(this);
+    m_actFindNext->setShortcut(Qt::Key_F3);
+    m_actFindNext->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    addAction(m_actFindNext);
+    m_mainLog->addAction(m_actFindNext);
+
+    m_actCount = new QAction(this);
 }
 
 void LogSearchWidget::translateUi()
@@ -141,7 +179,17 @@ void LogSearchWidget::translateUi()
     m_actExec->setText(tr("Search"));
     m_actExec->setIcon(Style::getIcon("search_icon.png"));
 
+    m_actFindPrev->setText(tr("Find Previous"));
+    m_actFindPrev->setIcon(Style::getIcon("up_icon.png"));
+
+    m_actFindNext->setText(tr("Find Next"));
+    m_actFindNext->setIcon(Style::getIcon("down_icon.png"));
+
+    m_actCount->setText(tr("Count Matches"));
+    m_actCount->setIcon(Style::getIcon("histogram_icon.png"));
+
     m_prlSearching->setActionText(tr("Searching"));
+    m_prlCounting->setActionText(tr("Counting"));
 }
 
 void LogSearchWidget::retranslateUi()
@@ -157,12 +205,19 @@ void LogSearchWidget::retranslateUi()
 void LogSearchWidget::createConnections()
 {
     connect(m_actExec, &QAction::triggered, this, &LogSearchWidget::startSearch);
+    connect(m_actFindPrev, &QAction::triggered, this, &LogSearchWidget::findPrev);
+    connect(m_actFindNext, &QAction::triggered, this, &LogSearchWidget::findNext);
+    connect(m_actCount, &QAction::triggered, this, &LogSearchWidget::startCount);
     connect(m_actClear, &QAction::triggered, this, &LogSearchWidget::clearResults);
     connect(m_actSyncMarks, &QAction::triggered, this, &LogSearchWidget::syncMarks);
     connect(m_actAddSearchParam, &QAction::triggered, this, &LogSearchWidget::addSearchParam);
     connect(m_sourceModel, &BaseLogModel::modelConfigured, this, &LogSearchWidget::sourceModelConfigured);
     connect(m_sourceModel, &BaseLogModel::valueFound, this, &LogSearchWidget::addSearchResult);
+    connect(m_sourceModel, &BaseLogModel::rowFound, this, &LogSearchWidget::rowFound);
+    connect(m_sourceModel, &BaseLogModel::histogramFound, this, &LogSearchWidget::histogramFound);
+    connect(m_histogram, &HistogramWidget::rowSelected, m_mainLog, &LogViewWidget::goToRow);
     connect(m_sourceModel, &BaseLogModel::searchingProgressChanged, m_prlSearching, &ProgressLabel::setProgress);
+    connect(m_sourceModel, &BaseLogModel::countingProgressChanged, m_prlCounting, &ProgressLabel::setProgress);
     connect(m_searchResults, &LogViewWidget::rowSelected, m_mainLog, &LogViewWidget::goToRow);
     connect(m_searchResults, &LogViewWidget::textMarkUpdated, m_mainLog, QOverload<>::of(&LogViewWidget::update));
     connect(m_mainLog, &LogViewWidget::textMarkUpdated, m_searchResults, QOverload<>::of(&LogViewWidget::update));
@@ -188,6 +243,19 @@ void LogSearchWidget::startSearch()
         clearResults();
     }
 
+    const tp::SearchParams params(getSearchParams());
+    if (!params.empty())
+    {
+        m_sourceModel->startSearch(params, m_actOrOperator->isChecked());
+    }
+    else
+    {
+        m_sourceModel->stopSearch();
+    }
+}
+
+tp::SearchParams LogSearchWidget::getSearchParams()
+{
     tp::SearchParams params;
 
     for (auto paramWidget : qAsConst(m_searchParamWidgets))
@@ -203,16 +271,62 @@ void LogSearchWidget::startSearch()
         }
     }
 
+    return params;
+}
+
+void LogSearchWidget::findPrev()
+{
+    const tp::SearchParams params(getSearchParams());
     if (!params.empty())
     {
-        m_sourceModel->startSearch(params, m_actOrOperator->isChecked());
+        // Without a selected row, it finds the last one.
+        const tp::SInt row(m_mainLog->getSelectedRow());
+        const tp::SInt fromRow((row < 0) ? static_cast<tp::SInt>(m_sourceModel->rowCount()) : row);
+        m_sourceModel->startFind(params, m_actOrOperator->isChecked(), fromRow, true);
+    }
+}
+
+void LogSearchWidget::findNext()
+{
+    // Only the nearest row is searched, from the selected one, so the search results are kept.
+    const tp::SearchParams params(getSearchParams());
+    if (!params.empty())
+    {
+        m_sourceModel->startFind(params, m_actOrOperator->isChecked(), m_mainLog->getSelectedRow(), false);
+    }
+}
+
+void LogSearchWidget::rowFound(tp::SInt row)
+{
+    if (row >= 0)
+    {
+        m_mainLog->goToRow(row);
+        m_mainLog->setFocus();
+    }
+}
+
+void LogSearchWidget::startCount()
+{
+    // Only the counts of the rows are kept, so the search results are not changed.
+    const tp::SearchParams params(getSearchParams());
+    if (!params.empty())
+    {
+        m_sourceModel->startCount(params, m_actOrOperator->isChecked());
     }
     else
     {
-        m_sourceModel->stopSearch();
+        m_sourceModel->stopCount();
+        m_histogram->clear();
+        m_histogram->hide();
     }
 }
 
+void LogSearchWidget::histogramFound(Histogram::Ptr histogram)
+{
+    m_histogram->setHistogram(histogram);
+    m_histogram->show();
+}
+
 void LogSearchWidget::addSearchResult(tp::SharedSIntList rowsPtr)
 {
     if (m_sourceModel->isSearching())
@@ -225,6 +339,9 @@ void LogSearchWidget::addSearchResult(tp::SharedSIntList rowsPtr)
 void LogSearchWidget::clearResults()
 {
     m_sourceModel->stopSearch();
+    m_sourceModel->stopCount();
+    m_histogram->clear();
+    m_histogram->hide();
     m_proxyModel->clear();
     m_searchResults->clearBookmarks();
     m_searchResults->updateView();
@@ -256,9 +373,14 @@ void LogSearchWidget::syncMarks()
     }
 
     m_searchResults->clearBookmarks();
+    RowSet mainLogMarks;
+    for (const auto mainLogRow : m_mainLog->getBookmarks())
+    {
+        mainLogMarks.add(mainLogRow);
+    }
+    m_proxyModel->addSourceRows(mainLogMarks);
     for (const auto mainLogRow : m_mainLog->getBookmarks())
     {
-        m_proxyModel->addSourceRow(mainLogRow);
         const auto row = m_proxyModel->findSourceRow(mainLogRow);
         if (row != -1)
         {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "Histogram.h"
 #include <QWidget>
 
 class QVBoxLayout;
@@ -14,6 +15,7 @@ class ProxyModel;
 class SearchParamWidget;
 class SearchParamModel;
 class ProgressLabel;
+class HistogramWidget;
 
 class LogSearchWidget : public QWidget
 {
@@ -32,6 +34,8 @@ private:
     void createToolBars();
     void createConnections();
     void translateUi();
+    // Applies the enabled params that have a pattern and returns them.
+    tp::SearchParams getSearchParams();
 
 signals:
     void rowSelected(tp::SInt row);
@@ -42,6 +46,11 @@ public slots:
 private slots:
     void addSearchParam();
     void startSearch();
+    void findPrev();
+    void findNext();
+    void rowFound(tp::SInt row);
+    void startCount();
+    void histogramFound(Histogram::Ptr histogram);
     void clearResults();
     void deleteParamWidget(QWidget *);
     void sourceModelConfigured();
@@ -55,12 +64,17 @@ private:
     QAction *m_actClear;
     QAction *m_actSyncMarks;
     QAction *m_actExec;
+    QAction *m_actFindPrev;
+    QAction *m_actFindNext;
+    QAction *m_actCount;
     QVBoxLayout *m_searchParamsLayout;
     LogViewWidget *m_mainLog;
     BaseLogModel *m_sourceModel;
     LogViewWidget *m_searchResults;
     ProxyModel *m_proxyModel;
     ProgressLabel *m_prlSearching;
+    ProgressLabel *m_prlCounting;
+    HistogramWidget *m_histogram;
     SearchParamModel *m_searchParamModel;
     QList<SearchParamWidget *> m_searchParamWidgets;
 };
@@ -15,9 +15,14 @@
 #include <QGuiApplication>
 #include <QClipboard>
 #include <QMenu>
+#include <QInputDialog>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 
+// The rows expected to be shown in this time, at the current scrolling speed, are prefetched.
+constexpr double g_prefetchSeconds(1.0);
+constexpr tp::SInt g_maxPrefetchRows(20000);
+
 LogViewWidget::LogViewWidget(AbstractModel *model, std::vector<tp::TextSelection> &markedTexts, QWidget *parent)
     : QWidget(parent),
       m_model(model),
@@ -151,6 +156,11 @@ LogViewWidget::LogViewWidget(AbstractModel *model, std::vector<tp::TextSelection
     m_actNextBookmark->setShortcutContext(Qt::WidgetShortcut);
     addAction(m_actNextBookmark);
 
+    m_actGoToTime = new QAction(this);
+    m_actGoToTime->setShortcut(Qt::CTRL | Qt::Key_T);
+    m_actGoToTime->setShortcutContext(Qt::WidgetShortcut);
+    addAction(m_actGoToTime);
+
     setFocusPolicy(Qt::StrongFocus);
     setFocus();
 
@@ -169,6 +179,7 @@ LogViewWidget::LogViewWidget(AbstractModel *model, std::vector<tp::TextSelection
     connect(m_actBookmark, &QAction::triggered, this, &LogViewWidget::bookmarkSelected);
     connect(m_actPrevBookmark, &QAction::triggered, this, &LogViewWidget::goToPrevBookmark);
     connect(m_actNextBookmark, &QAction::triggered, this, &LogViewWidget::goToNextBookmark);
+    connect(m_actGoToTime, &QAction::triggered, this, &LogViewWidget::goToTime);
     connect(m_actGoUp, &QAction::triggered, this, &LogViewWidget::goToPrevRow);
     connect(m_actGoDown, &QAction::triggered, this, &LogViewWidget::goToNextRow);
     connect(m_actGoPrevPage, &QAction::triggered, this, &LogViewWidget::goToPrevPage);
@@ -239,6 +250,8 @@ void LogViewWidget::translateUi()
 
     m_actNextBookmark->setText(tr("Next Bookmark"));
 
+    m_actGoToTime->setText(tr("Go to Time"));
+
     m_btnExpandColumns->setToolTip(tr("Expand All Columns"));
     m_btnExpandColumns->setIcon(Style::getIcon("expand_icon.png"));
 
@@ -259,6 +272,11 @@ AbstractModel *LogViewWidget::getModel()
     return m_model;
 }
 
+tp::SInt LogViewWidget::getSelectedRow() const
+{
+    return m_selectedRow.value_or(-1);
+}
+
 void LogViewWidget::headerChanged()
 {
     updateView();
@@ -292,9 +310,52 @@ void LogViewWidget::vScrollBarPosChanged()
         emit autoScrollingChanged(m_autoScrolling);
     }
 
+    prefetchRows();
     update();
 }
 
+void LogViewWidget::prefetchRows()
+{
+    const double velocity(m_vScrollBar->getVelocity());
+    if (velocity == 0.0)
+    {
+        return;
+    }
+
+    const tp::SInt pos(m_vScrollBar->getPos());
+    const tp::SInt rowCount(m_model->rowCount());
+    const tp::SInt distance(
+        std::clamp<tp::SInt>(std::abs(velocity) * g_prefetchSeconds, m_itemsPerPage, g_maxPrefetchRows));
+
+    // The rows ahead come first, then a page in the opposite direction, in case the scrolling turns back.
+    std::vector<tp::SInt> rows;
+    rows.reserve(distance + m_itemsPerPage);
+    if (velocity > 0.0)
+    {
+        for (tp::SInt row = pos + m_itemsPerPage; (row < pos + m_itemsPerPage + distance) && (row < rowCount); ++row)
+        {
+            rows.push_back(row);
+        }
+        for (tp::SInt row = pos - 1; (row >= pos - m_itemsPerPage) && (row >= 0); --row)
+        {
+            rows.push_back(row);
+        }
+    }
+    else
+    {
+        for (tp::SInt row = pos - 1; (row >= pos - distance) && (row >= 0); --row)
+        {
+            rows.push_back(row);
+        }
+        for (tp::SInt row = pos + m_itemsPerPage; (row < pos + (m_itemsPerPage * 2)) && (row < rowCount); ++row)
+        {
+            rows.push_back(row);
+        }
+    }
+
+    m_model->prefetchRows(rows);
+}
+
 void LogViewWidget::hScrollBarPosChanged()
 {
     m_header->setOffset(m_hScrollBar->getPos());
@@ -416,6 +477,7 @@ void LogViewWidget::mousePressEvent(QMouseEvent *event)
         m_actCopy->setEnabled(canCopy());
         m_actPrevBookmark->setEnabled(hasPrevBookmark());
         m_actNextBookmark->setEnabled(hasNextBookmark());
+        m_actGoToTime->setEnabled(m_model->getTimeColumn() != nullptr);
 
         QMenu menu(this);
         menu.addAction(m_actCopy);
@@ -423,6 +485,8 @@ void LogViewWidget::mousePressEvent(QMouseEvent *event)
         menu.addAction(m_actBookmark);
         menu.addAction(m_actPrevBookmark);
         menu.addAction(m_actNextBookmark);
+        menu.addSeparator();
+        menu.addAction(m_actGoToTime);
 
         menu.addSeparator();
 
@@ -464,6 +528,7 @@ void LogViewWidget::mousePressEvent(QMouseEvent *event)
         m_actCopy->setEnabled(true);
         m_actPrevBookmark->setEnabled(true);
         m_actNextBookmark->setEnabled(true);
+        m_actGoToTime->setEnabled(true);
     }
 }
 
@@ -672,14 +737,7 @@ void LogViewWidget::getVisualRowData(tp::SInt row, tp::SInt rowOffset, tp::SInt
     vrData.numberRect =
         QRect(Style::getTextPadding(), yOffset, m_textAreaRect.left() - Style::getTextPadding() * 2, m_rowHeight);
 
-    for (const auto &highlighter : m_highlightersRows)
-    {
-        if (highlighter.matchInRow(rowData))
-        {
-            vrData.highlighter = &highlighter;
-            break;
-        }
-    }
+    vrData.highlighter = m_highlightersRows.findInRow(rowData);
 
     std::optional<QRect> selectText;
     if (m_selectStart.has_value() && m_selectEnd.has_value())
@@ -734,7 +792,7 @@ void LogViewWidget::getVisualRowData(tp::SInt row, tp::SInt rowOffset, tp::SInt
                         vcData.selection = std::move(textSelection);
                     }
                 }
-                vcData.markedTexts = findMarkedText(tp::TextCan(rect, colText));
+                vcData.markedTexts = findMarkedText(tp::TextCan(rect, colText), rowData[idx]);
             }
             vrData.columns.emplace_back(std::move(vcData));
             rect.moveLeft(rect.left() + rect.width());
@@ -761,7 +819,7 @@ void LogViewWidget::getVisualRowData(tp::SInt row, tp::SInt rowOffset, tp::SInt
                     vcData.selection = std::move(textSelection);
                 }
             }
-            vcData.markedTexts = findMarkedText(vcData.can);
+            vcData.markedTexts = findMarkedText(vcData.can, colText);
             vrData.columns.emplace_back(std::move(vcData));
             rect.moveLeft(rect.left() + rect.width());
         }
@@ -829,11 +887,7 @@ QString LogViewWidget::getElidedText(const QString &text, tp::SInt width, bool s
 
 void LogViewWidget::configure(FileConf::Ptr conf)
 {
-    m_highlightersRows.clear();
-    for (const auto &param : conf->getHighlighterParams())
-    {
-        m_highlightersRows.push_back(Highlighter(param));
-    }
+    m_highlightersRows.setParams(conf->getHighlighterParams());
 }
 
 void LogViewWidget::reconfigure(FileConf::Ptr conf)
@@ -978,40 +1032,81 @@ qreal LogViewWidget::getCharMarging()
     return Style::getCharWidthF() / 4.0;
 }
 
-std::vector<tp::TextSelection> LogViewWidget::findMarkedText(const tp::TextCan &can)
+std::vector<tp::TextSelection> LogViewWidget::findMarkedText(const tp::TextCan &can, std::string_view utf8Text)
 {
     std::vector<tp::TextSelection> resVec;
 
-    const auto findAndMarkFunc = [&, this](const QString &text, const tp::SectionColor &color)
+    updateMarkedTextsSearch();
+    if (m_markedTextsSearch.empty())
     {
-        if (!text.isEmpty())
+        return resVec;
+    }
+
+    std::vector<std::pair<tp::UInt, tp::UInt>> hits;
+    m_markedTextsSearch.scan(
+        utf8Text,
+        [&hits](tp::UInt id, tp::UInt pos)
         {
-            auto idx = can.text.indexOf(text);
-            while (idx != -1)
-            {
-                const auto &selCan = makeSelCanFromStrPos(can, idx, text.size());
+            hits.emplace_back(id, pos);
+            return true;
+        });
 
-                tp::TextSelection selText;
-                selText.can = selCan;
-                selText.color = color;
-                resVec.emplace_back(std::move(selText));
+    // The selections are painted in the order of the marks, and then the selected text.
+    std::stable_sort(
+        hits.begin(),
+        hits.end(),
+        [](const auto &lhs, const auto &rhs) { return (lhs.first < rhs.first); });
 
-                idx = can.text.indexOf(text, ++idx);
-            }
-        }
+    // Only an ascii text has the same positions in utf-8 and in the QString.
+    const bool isAscii(utf8Text.size() == static_cast<tp::UInt>(can.text.size()));
+    for (const auto &[id, pos] : hits)
+    {
+        const tp::UInt textIdx(m_markedTextsSearchIdx[id]);
+        const int idx = isAscii ? static_cast<int>(pos) : QString::fromUtf8(utf8Text.data(), pos).size();
+        const auto &selCan = makeSelCanFromStrPos(can, idx, m_markedTextsSearchTexts[textIdx].size());
+
+        tp::TextSelection selText;
+        selText.can = selCan;
+        selText.color =
+            (textIdx < m_markedTexts.size()) ? m_markedTexts[textIdx].color : Style::getSelectedTextMarkColor();
+        resVec.emplace_back(std::move(selText));
+    }
+
+    return resVec;
+}
+
+void LogViewWidget::updateMarkedTextsSearch()
+{
+    const tp::UInt count(m_markedTexts.size() + (m_selectedText.has_value() ? 1 : 0));
+    const auto getText = [this](tp::UInt idx) -> const QString &
+    {
+        return (idx < m_markedTexts.size()) ? m_markedTexts[idx].can.text : m_selectedText.value();
     };
 
-    for (const auto &markedText : m_markedTexts)
+    bool upToDate(m_markedTextsSearchTexts.size() == count);
+    for (tp::UInt i = 0; upToDate && (i < count); ++i)
     {
-        findAndMarkFunc(markedText.can.text, markedText.color);
+        upToDate = (m_markedTextsSearchTexts[i] == getText(i));
     }
-
-    if (m_selectedText.has_value())
+    if (upToDate)
     {
-        findAndMarkFunc(m_selectedText.value(), Style::getSelectedTextMarkColor());
+        return;
     }
 
-    return resVec;
+    m_markedTextsSearch.clear();
+    m_markedTextsSearchTexts.clear();
+    m_markedTextsSearchIdx.clear();
+    for (tp::UInt i = 0; i < count; ++i)
+    {
+        const QString &text = getText(i);
+        m_markedTextsSearchTexts.push_back(text);
+        if (!text.isEmpty())
+        {
+            m_markedTextsSearch.add(text.toStdString(), true);
+            m_markedTextsSearchIdx.push_back(i);
+        }
+    }
+    m_markedTextsSearch.build();
 }
 
 tp::TextCan LogViewWidget::makeSelCanFromStrPos(const tp::TextCan &can, int fromPos, int len)
@@ -1300,6 +1395,43 @@ void LogViewWidget::goToNextBookmark()
     }
 }
 
+void LogViewWidget::goToTime()
+{
+    const tp::Column *column = (m_model != nullptr) ? m_model->getTimeColumn() : nullptr;
+    if (column == nullptr)
+    {
+        return;
+    }
+
+    // Starts from the time of the selected row, so only a part of it needs to be edited.
+    QString time;
+    tp::RowData rowData;
+    if (m_selectedRow.has_value() && (m_model->getRow(m_selectedRow.value(), rowData) >= 0) &&
+        (static_cast<tp::UInt>(column->idx) < rowData.size()))
+    {
+        time = QString::fromStdString(rowData[column->idx]);
+    }
+
+    bool ok(false);
+    time = QInputDialog::getText(
+        this,
+        tr("Go to Time"),
+        tr("Time (%1)").arg(QString::fromStdString(column->format)),
+        QLineEdit::Normal,
+        time,
+        &ok);
+    if (!ok || time.isEmpty())
+    {
+        return;
+    }
+
+    const tp::SInt row(m_model->findRowByTime(time.toStdString()));
+    if (row >= 0)
+    {
+        goToRow(row);
+    }
+}
+
 void LogViewWidget::bookmarkSelected()
 {
     if (m_selectStart.has_value() && m_selectEnd.has_value())
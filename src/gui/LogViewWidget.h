@@ -48,6 +48,8 @@ public:
 
     bool canCopy() const;
     AbstractModel *getModel();
+    // Returns the selected row, or -1.
+    tp::SInt getSelectedRow() const;
     const std::set<tp::SInt> &getBookmarks();
     void clearBookmarks();
     bool hasBookmark(tp::SInt row) const;
@@ -81,6 +83,7 @@ public slots:
     void goFullRight();
     void goToPrevBookmark();
     void goToNextBookmark();
+    void goToTime();
     void addTextMark(const QString &text, const tp::SectionColor &selColor);
     void removeTextMarks(const tp::SectionColor &selColor);
     void setAutoScrolling(bool autoScrolling);
@@ -119,7 +122,8 @@ protected:
     void getColumnsSizeToScreen(tp::ColumnsRef &columnsRef);
 
     qreal getCharMarging();
-    std::vector<tp::TextSelection> findMarkedText(const tp::TextCan &can);
+    std::vector<tp::TextSelection> findMarkedText(const tp::TextCan &can, std::string_view utf8Text);
+    void updateMarkedTextsSearch();
     tp::TextCan makeSelCanFromStrPos(const tp::TextCan &can, int fromPos, int len);
     tp::TextCan makeSelCanFromSelRect(const tp::TextCan &can, const QRect &selRect);
     int getStrWidthUntilPos(int pos, int maxWidth = std::numeric_limits<int>::max());
@@ -138,6 +142,7 @@ private:
     void translateUi();
     void updatePalette();
     void updateHeaderSize();
+    void prefetchRows();
 
     AbstractModel *m_model;
     std::vector<tp::TextSelection> &m_markedTexts;
@@ -163,6 +168,7 @@ private:
     QAction *m_actBookmark;
     QAction *m_actPrevBookmark;
     QAction *m_actNextBookmark;
+    QAction *m_actGoToTime;
     tp::SInt m_rowHeight = 0;
     tp::SInt m_itemsPerPage = 0;
     QRect m_textAreaRect;
@@ -171,7 +177,12 @@ private:
     std::optional<std::pair<tp::SInt, int>> m_selectStart;
     std::optional<std::pair<tp::SInt, int>> m_selectEnd;
     std::set<tp::SInt> m_bookMarks;
-    std::vector<Highlighter> m_highlightersRows;
+    Highlighters m_highlightersRows;
+    // The marked texts and the selected text, all searched in a single pass over each column.
+    AhoCorasick m_markedTextsSearch;
+    std::vector<QString> m_markedTextsSearchTexts;
+    // Index in m_markedTextsSearchTexts of each pattern of m_markedTextsSearch.
+    std::vector<tp::UInt> m_markedTextsSearchIdx;
     std::vector<tp::SectionColor> m_availableMarks;
     bool m_autoScrolling = false;
 };
@@ -7,6 +7,9 @@
 #include <QPaintEvent>
 #include <QPainter>
 
+// Position changes further apart than this are considered a new movement.
+constexpr qint64 g_velocityResetMs(300);
+
 LongScrollBar::LongScrollBar(Qt::Orientation orientation, QWidget *parent) : QWidget(parent), m_orientation(orientation)
 {
     m_knobRect.setLeft(0);
@@ -60,6 +63,15 @@ tp::SInt LongScrollBar::getPos() const
     return m_pos;
 }
 
+double LongScrollBar::getVelocity() const
+{
+    if (!m_velocityTimer.isValid() || m_velocityTimer.hasExpired(g_velocityResetMs))
+    {
+        return 0.0;
+    }
+    return m_velocity;
+}
+
 void LongScrollBar::setPosPerStep(int positions)
 {
     m_posPerStep = positions;
@@ -282,6 +294,23 @@ void LongScrollBar::changePos(tp::SInt pos)
 
     if (m_pos != pos)
     {
+        updateVelocity(pos - m_pos);
         m_pos = pos;
     }
+}
+
+void LongScrollBar::updateVelocity(tp::SInt delta)
+{
+    if (!m_velocityTimer.isValid() || m_velocityTimer.hasExpired(g_velocityResetMs))
+    {
+        m_velocityTimer.start();
+        // Only the direction is known at the start of a movement.
+        m_velocity = (delta > 0) ? 1.0 : -1.0;
+        return;
+    }
+
+    // The instant velocity is smoothed, as the events are not evenly spaced.
+    const qint64 elapsed(std::max<qint64>(m_velocityTimer.restart(), 1));
+    const double velocity((delta * 1000.0) / elapsed);
+    m_velocity = (m_velocity * 0.5) + (velocity * 0.5);
 }
\ No newline at end of file
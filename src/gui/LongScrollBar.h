@@ -16,6 +16,8 @@ public:
     tp::SInt getMax() const;
     void setPos(tp::SInt pos);
     tp::SInt getPos() const;
+    // Smoothed speed of the position changes in positions per second, negative when moving backwards.
+    double getVelocity() const;
     void setPosPerStep(int positions);
     bool isKnobGrabbed();
     void wheelEvent(QWheelEvent *event) override;
@@ -39,6 +41,7 @@ protected:
     void updateKnob();
     void changeMax(tp::SInt max);
     void changePos(tp::SInt pos);
+    void updateVelocity(tp::SInt delta);
 
 private:
     Qt::Orientation m_orientation;
@@ -49,4 +52,6 @@ private:
     double m_sizePerPos = 1.0;
     std::pair<int, int> m_wheelDegrees = {false, 0};
     int m_posPerStep = 1;
+    double m_velocity = 0.0;
+    QElapsedTimer m_velocityTimer;
 };
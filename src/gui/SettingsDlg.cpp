@@ -10,6 +10,7 @@
 #include <QFormLayout>
 #include <QHBoxLayout>
 #include <QLineEdit>
+#include <QSpinBox>
 #include <QVBoxLayout>
 #include <QGroupBox>
 #include <QDialogButtonBox>
@@ -57,6 +58,8 @@ void SettingsDlg::load()
 
     m_chkRegexAsDefault->setChecked(Settings::getDefaultSearchType() == tp::SearchType::Regex);
 
+    m_spnChunkCacheSize->setValue(Settings::getChunkCacheSize());
+
     m_edtSettingsPath->setText(Settings::getSettingsDir().absolutePath());
     m_edtTemplatesPath->setText(Settings::gettemplatesDir().absolutePath());
 }
@@ -133,6 +136,12 @@ void SettingsDlg::save()
         Settings::setDefaultSearchType(searchType);
     }
 
+    const tp::UInt chunkCacheSize(m_spnChunkCacheSize->value());
+    if (Settings::getChunkCacheSize() != chunkCacheSize)
+    {
+        Settings::setChunkCacheSize(chunkCacheSize);
+    }
+
     QDialog::accept();
 }
 
@@ -214,6 +223,20 @@ void SettingsDlg::buildLayout()
     vLayoutMain->addWidget(grBehavior);
     // Behavior ------------------------------------------------------------------------- (End)
 
+    // Performance ---------------------------------------------------------------------- (Start)
+    auto grPerformance = new QGroupBox(tr("Performance"), this);
+    auto frmPerformance = new QFormLayout(grPerformance);
+
+    m_spnChunkCacheSize = new QSpinBox(grPerformance);
+    m_spnChunkCacheSize->setRange(8, 4096);
+    m_spnChunkCacheSize->setSuffix(" MB");
+    m_spnChunkCacheSize->setToolTip(tr("Memory used by each file to keep its recently viewed rows.\n"
+                                       "It applies to the files opened afterwards."));
+    frmPerformance->addRow(tr("Row cache per file"), m_spnChunkCacheSize);
+
+    vLayoutMain->addWidget(grPerformance);
+    // Performance ---------------------------------------------------------------------- (End)
+
     // Paths ---------------------------------------------------------------------------- (Start)
     auto grPaths = new QGroupBox(tr("Paths"), this);
     auto frmPaths = new QFormLayout(grPaths);
@@ -8,6 +8,7 @@
 class QCheckBox;
 class QComboBox;
 class QLineEdit;
+class QSpinBox;
 class QDialogButtonBox;
 
 class SettingsDlg : public QDialog
@@ -33,6 +34,7 @@ private:
     QCheckBox *m_chkHideUniqueTab;
     QCheckBox *m_chkAllowMultiInst;
     QCheckBox *m_chkRegexAsDefault;
+    QSpinBox *m_spnChunkCacheSize;
     QLineEdit *m_edtSettingsPath;
     QLineEdit *m_edtTemplatesPath;
     QDialogButtonBox *m_buttonBox;
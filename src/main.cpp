@@ -5,6 +5,7 @@
 #include "MainWindow.h"
 #include "Settings.h"
 #include "Style.h"
+#include "Histogram.h"
 #include <QApplication>
 #include <QtSingleApplication>
 #include <QStyleFactory>
@@ -18,6 +19,7 @@ int main(int argc, char *argv[])
     qRegisterMetaType<tp::SInt>("tp::SInt");
     qRegisterMetaType<tp::UInt>("tp::UInt");
     qRegisterMetaType<tp::SharedSIntList>("tp::SharedSIntList");
+    qRegisterMetaType<Histogram::Ptr>("Histogram::Ptr");
 
     QtSingleApplication app(argc, argv);
 
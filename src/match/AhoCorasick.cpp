@@ -0,0 +1,102 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "AhoCorasick.h"
+
+tp::UInt AhoCorasick::add(std::string_view pattern, bool matchCase)
+{
+    auto &added = m_patterns.emplace_back();
+    added.text = pattern;
+    added.matchCase = matchCase;
+    return m_patterns.size() - 1;
+}
+
+void AhoCorasick::clear()
+{
+    m_patterns.clear();
+    m_classes.fill(0);
+    m_classCount = 1;
+    m_delta.clear();
+    m_outBegin.clear();
+    m_outputs.clear();
+}
+
+void AhoCorasick::build()
+{
+    // Only the bytes of the patterns get their own class, which keeps the transition table small.
+    std::array<std::uint32_t, 256> foldedClasses{};
+    m_classCount = 1;
+    for (const auto &pattern : m_patterns)
+    {
+        for (const char c : pattern.text)
+        {
+            auto &cls = foldedClasses[static_cast<unsigned char>(AsciiFoldSearcher::fold(c))];
+            if (cls == 0)
+            {
+                cls = m_classCount++;
+            }
+        }
+    }
+    for (tp::UInt c = 0; c < m_classes.size(); ++c)
+    {
+        m_classes[c] = foldedClasses[static_cast<unsigned char>(AsciiFoldSearcher::fold(static_cast<char>(c)))];
+    }
+
+    // Trie of the patterns, where the transition to the root, state 0, means that there is none yet.
+    m_delta.assign(m_classCount, 0);
+    std::vector<std::vector<std::uint32_t>> stateOutputs(1);
+    for (std::uint32_t id = 0; id < m_patterns.size(); ++id)
+    {
+        std::uint32_t state = 0;
+        for (const char c : m_patterns[id].text)
+        {
+            auto next = m_delta[state * m_classCount + m_classes[static_cast<unsigned char>(c)]];
+            if (next == 0)
+            {
+                next = static_cast<std::uint32_t>(stateOutputs.size());
+                m_delta[state * m_classCount + m_classes[static_cast<unsigned char>(c)]] = next;
+                m_delta.resize(m_delta.size() + m_classCount, 0);
+                stateOutputs.emplace_back();
+            }
+            state = next;
+        }
+        stateOutputs[state].push_back(id);
+    }
+
+    // The states are completed in breadth-first order, so the failure state of each one is already complete.
+    // The missing transitions are taken from the failure state, and so are its outputs.
+    std::vector<std::uint32_t> fail(stateOutputs.size(), 0);
+    std::deque<std::uint32_t> queue{0};
+    while (!queue.empty())
+    {
+        const auto state = queue.front();
+        queue.pop_front();
+        for (std::uint32_t cls = 0; cls < m_classCount; ++cls)
+        {
+            auto &next = m_delta[state * m_classCount + cls];
+            const std::uint32_t failNext = (state == 0) ? 0 : m_delta[fail[state] * m_classCount + cls];
+            if (next == 0)
+            {
+                next = failNext;
+            }
+            else
+            {
+                fail[next] = failNext;
+                const auto &failOutputs = stateOutputs[failNext];
+                stateOutputs[next].insert(stateOutputs[next].end(), failOutputs.begin(), failOutputs.end());
+                queue.push_back(next);
+            }
+        }
+    }
+
+    m_outBegin.clear();
+    m_outputs.clear();
+    m_outBegin.reserve(stateOutputs.size() + 1);
+    for (const auto &outputs : stateOutputs)
+    {
+        m_outBegin.push_back(static_cast<std::uint32_t>(m_outputs.size()));
+        m_outputs.insert(m_outputs.end(), outputs.begin(), outputs.end());
+    }
+    m_outBegin.push_back(static_cast<std::uint32_t>(m_outputs.size()));
+}
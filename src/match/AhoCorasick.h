@@ -0,0 +1,65 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include "AsciiFoldSearcher.h"
+
+// Aho-Corasick automaton, which finds all the occurrences of many patterns in a single pass over the text.
+// The transitions are over the ascii folded bytes, so a pattern that matches the case shares the states with the
+// ones that ignore it, and its hits are confirmed against the text.
+class AhoCorasick
+{
+public:
+    // Below this number of patterns, searching each one on its own is faster.
+    static constexpr tp::UInt s_minPatterns = 8;
+
+    // Returns the id of the pattern, which is its order of addition. The pattern must not be empty.
+    tp::UInt add(std::string_view pattern, bool matchCase);
+    // Must be called after adding the patterns and before scanning.
+    void build();
+    void clear();
+    bool empty() const { return m_patterns.empty(); }
+    tp::UInt size() const { return m_patterns.size(); }
+
+    // Calls onHit(id, pos) for every occurrence, in the order of its end in the text, until it returns false.
+    template <typename OnHit>
+    void scan(std::string_view text, OnHit &&onHit) const
+    {
+        std::uint32_t state = 0;
+        for (tp::UInt i = 0; i < text.size(); ++i)
+        {
+            state = m_delta[state * m_classCount + m_classes[static_cast<unsigned char>(text[i])]];
+            for (std::uint32_t o = m_outBegin[state]; o < m_outBegin[state + 1]; ++o)
+            {
+                const auto &pattern = m_patterns[m_outputs[o]];
+                const tp::UInt pos = i + 1 - pattern.text.size();
+                if (pattern.matchCase && (text.compare(pos, pattern.text.size(), pattern.text) != 0))
+                {
+                    continue;
+                }
+                if (!onHit(static_cast<tp::UInt>(m_outputs[o]), pos))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    struct Pattern
+    {
+        std::string text;
+        bool matchCase = true;
+    };
+
+    std::vector<Pattern> m_patterns;
+    // Class of each byte, by its folded value. The class 0 is of the bytes that no pattern has.
+    std::array<std::uint32_t, 256> m_classes{};
+    std::uint32_t m_classCount = 1;
+    // Next state of each state and class.
+    std::vector<std::uint32_t> m_delta;
+    // The ids of the patterns ending at the state s are in m_outputs[m_outBegin[s], m_outBegin[s + 1]).
+    std::vector<std::uint32_t> m_outBegin;
+    std::vector<std::uint32_t> m_outputs;
+};
@@ -0,0 +1,80 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "AsciiFoldSearcher.h"
+
+namespace
+{
+
+std::array<unsigned char, 256> makeFoldTable()
+{
+    std::array<unsigned char, 256> table;
+    for (tp::UInt c = 0; c < table.size(); ++c)
+    {
+        table[c] = ((c >= 'a') && (c <= 'z')) ? (c & ~0x20) : c;
+    }
+    return table;
+}
+
+} // namespace
+
+const std::array<unsigned char, 256> AsciiFoldSearcher::s_foldTable(makeFoldTable());
+
+AsciiFoldSearcher::AsciiFoldSearcher(std::string_view pattern) : m_pattern(pattern)
+{
+    for (auto &c : m_pattern)
+    {
+        c = fold(c);
+    }
+
+    // The shift is indexed by the raw text byte, so both cases of a letter get the same one.
+    const tp::UInt last(m_pattern.empty() ? 0 : (m_pattern.size() - 1));
+    m_skip.fill(std::max<tp::UInt>(m_pattern.size(), 1));
+    for (tp::UInt i = 0; i < last; ++i)
+    {
+        const auto c = static_cast<unsigned char>(m_pattern[i]);
+        m_skip[c] = last - i;
+        if ((c >= 'A') && (c <= 'Z'))
+        {
+            m_skip[c | 0x20] = last - i;
+        }
+    }
+}
+
+std::string_view::size_type AsciiFoldSearcher::find(std::string_view text, std::string_view::size_type pos) const
+{
+    const tp::UInt size(m_pattern.size());
+    if (size == 0)
+    {
+        return (pos <= text.size()) ? pos : std::string_view::npos;
+    }
+
+    const char *pattern = m_pattern.data();
+    const char *data = text.data();
+    const tp::UInt last(size - 1);
+    const char lastChar(pattern[last]);
+
+    for (tp::UInt i = pos; (i + size) <= text.size(); i += m_skip[static_cast<unsigned char>(data[i + last])])
+    {
+        if (fold(data[i + last]) == lastChar)
+        {
+            tp::UInt j(0);
+            while ((j < last) && (fold(data[i + j]) == pattern[j]))
+            {
+                ++j;
+            }
+            if (j == last)
+            {
+                return i;
+            }
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+bool AsciiFoldSearcher::isAscii(std::string_view text)
+{
+    return std::all_of(text.begin(), text.end(), [](char c) { return !(static_cast<unsigned char>(c) & 0x80); });
+}
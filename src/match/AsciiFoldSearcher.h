@@ -0,0 +1,27 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include <array>
+
+// Boyer-Moore-Horspool substring search that ignores the case of the ascii letters.
+// The text is folded on the fly through a table, so a search allocates nothing.
+class AsciiFoldSearcher
+{
+public:
+    AsciiFoldSearcher(std::string_view pattern);
+
+    std::string_view::size_type find(std::string_view text, std::string_view::size_type pos = 0) const;
+    tp::UInt size() const { return m_pattern.size(); }
+
+    static char fold(char c) { return static_cast<char>(s_foldTable[static_cast<unsigned char>(c)]); }
+    static bool isAscii(std::string_view text);
+
+private:
+    static const std::array<unsigned char, 256> s_foldTable;
+
+    // Folded to upper case.
+    std::string m_pattern;
+    std::array<tp::UInt, 256> m_skip;
+};
@@ -0,0 +1,213 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "LiteralFilter.h"
+#include "RegexLiterals.h"
+#include <cstring>
+
+namespace
+{
+
+// Whether a literal found in a column of a json row is always in the raw row as well.
+// The json escapes change the raw text, and the numbers and booleans are formatted into the columns.
+// The non-ascii characters may be written as \u escapes, so they are rejected as well. The object and array
+// columns are serialized again, so their structural characters and whitespace may differ from the raw ones.
+bool isRawInJson(std::string_view literal)
+{
+    const auto isChangeable = [](char c)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        return (byte <= 0x20) || (byte >= 0x80) || (std::strchr("\"\\/<>&':,[]{}", c) != nullptr);
+    };
+    const auto isNumeric = [](char c) { return ((c >= '0') && (c <= '9')) || (c == '.') || (c == '-'); };
+    if (std::any_of(literal.begin(), literal.end(), isChangeable) ||
+        std::all_of(literal.begin(), literal.end(), isNumeric))
+    {
+        return false;
+    }
+
+    const std::string upper(utl::toUpper(literal));
+    return (std::string_view("TRUE").find(upper) == std::string_view::npos) &&
+           (std::string_view("FALSE").find(upper) == std::string_view::npos);
+}
+
+} // namespace
+
+void LiteralFilter::Hits::clear()
+{
+    m_ranges.clear();
+    m_next = 0;
+}
+
+bool LiteralFilter::Hits::inRow(tp::UInt rowStart, tp::UInt rowEnd)
+{
+    // Checking the rows backwards, the first hit of the row is searched again.
+    if ((m_next > 0) && (m_ranges[m_next - 1].first >= rowStart))
+    {
+        const auto it = std::lower_bound(
+            m_ranges.begin(),
+            m_ranges.begin() + m_next,
+            rowStart,
+            [](const std::pair<tp::UInt, tp::UInt> &range, tp::UInt start) { return (range.first < start); });
+        m_next = it - m_ranges.begin();
+    }
+
+    while ((m_next < m_ranges.size()) && (m_ranges[m_next].first < rowStart))
+    {
+        ++m_next;
+    }
+
+    for (tp::UInt i = m_next; (i < m_ranges.size()) && (m_ranges[i].first < rowEnd); ++i)
+    {
+        if (m_ranges[i].second <= rowEnd)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+LiteralFilter::LiteralFilter(const tp::SearchParams &params, bool orOp, tp::FileType fileType)
+    : m_json(fileType == tp::FileType::Json)
+{
+    const auto addLiteral = [this](std::string &&text, const tp::SearchParam &param)
+    {
+        auto &literal = m_literals.emplace_back();
+        literal.text = std::move(text);
+        literal.matchCase = param.flags.has(tp::SearchFlag::MatchCase);
+        if (!literal.matchCase)
+        {
+            literal.foldSearcher.emplace(literal.text);
+        }
+    };
+
+    for (const auto &param : params)
+    {
+        const bool notOp(param.flags.has(tp::SearchFlag::NotOperator));
+        auto text = notOp ? std::nullopt : getLiteral(param, fileType);
+
+        if (orOp)
+        {
+            // A row may match any of the params, so all of them need a literal.
+            if (!text.has_value())
+            {
+                m_literals.clear();
+                return;
+            }
+            addLiteral(std::move(text.value()), param);
+        }
+        else if (text.has_value() && (m_literals.empty() || (text->size() > m_literals.front().text.size())))
+        {
+            // A row must match all the params, so the longest literal is enough.
+            m_literals.clear();
+            addLiteral(std::move(text.value()), param);
+        }
+    }
+
+    if (m_literals.size() >= AhoCorasick::s_minPatterns)
+    {
+        for (const auto &literal : m_literals)
+        {
+            m_automaton.add(literal.text, literal.matchCase);
+        }
+        m_automaton.build();
+    }
+}
+
+std::optional<std::string> LiteralFilter::getLiteral(const tp::SearchParam &param, tp::FileType fileType)
+{
+    const bool matchCase(param.flags.has(tp::SearchFlag::MatchCase));
+
+    std::optional<std::string> literal;
+    if (param.type == tp::SearchType::SubString)
+    {
+        literal = param.pattern;
+    }
+    else if (param.type == tp::SearchType::Regex)
+    {
+        literal = RegexLiterals::getLongest(param.pattern, matchCase);
+    }
+
+    // The literal must not cross the line breaks, which split the text rows.
+    if (!literal.has_value() || literal->empty() || (literal->find('\n') != std::string::npos))
+    {
+        return std::nullopt;
+    }
+
+    // A non ascii pattern is compared by the matcher with the unicode case folding, which is not done here.
+    if ((!matchCase && !AsciiFoldSearcher::isAscii(literal.value())) ||
+        ((fileType == tp::FileType::Json) && !isRawInJson(literal.value())))
+    {
+        return std::nullopt;
+    }
+
+    return literal;
+}
+
+bool LiteralFilter::find(std::string_view data, Hits &hits) const
+{
+    hits.clear();
+
+    // Any ascii character may be written as a \u escape as well, which the literals don't match.
+    if (m_json && (data.find("\\u") != std::string_view::npos))
+    {
+        return false;
+    }
+
+    if (!m_automaton.empty())
+    {
+        m_automaton.scan(
+            data,
+            [&](tp::UInt id, tp::UInt pos)
+            {
+                hits.m_ranges.emplace_back(pos, pos + m_literals[id].text.size());
+                return true;
+            });
+    }
+    else
+    {
+        findEach(data, hits);
+    }
+
+    if (m_literals.size() > 1)
+    {
+        std::sort(hits.m_ranges.begin(), hits.m_ranges.end());
+    }
+    return true;
+}
+
+void LiteralFilter::findEach(std::string_view data, Hits &hits) const
+{
+    for (const auto &literal : m_literals)
+    {
+        const tp::UInt size(literal.text.size());
+        if (literal.matchCase)
+        {
+#if defined(__GLIBC__) || defined(__APPLE__)
+            const char *begin = data.data();
+            const char *end = begin + data.size();
+            const char *it = begin;
+            while ((it = static_cast<const char *>(::memmem(it, end - it, literal.text.data(), size))) != nullptr)
+            {
+                hits.m_ranges.emplace_back(it - begin, it - begin + size);
+                it += size;
+            }
+#else
+            for (auto pos = data.find(literal.text); pos != std::string_view::npos;
+                 pos = data.find(literal.text, pos + size))
+            {
+                hits.m_ranges.emplace_back(pos, pos + size);
+            }
+#endif
+        }
+        else
+        {
+            const auto &searcher = literal.foldSearcher.value();
+            for (auto pos = searcher.find(data); pos != std::string_view::npos; pos = searcher.find(data, pos + size))
+            {
+                hits.m_ranges.emplace_back(pos, pos + size);
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include "AsciiFoldSearcher.h"
+#include "AhoCorasick.h"
+
+// Prefilter of the search, which looks in the raw data for the literals that the matching rows must contain,
+// so the rows without them are neither parsed nor matched.
+class LiteralFilter
+{
+public:
+    // Ranges of the data, [start, end), that may make the row containing them match.
+    class Hits
+    {
+    public:
+        void clear();
+        // Whether the row at [rowStart, rowEnd) contains a hit. The rows are best checked in order.
+        bool inRow(tp::UInt rowStart, tp::UInt rowEnd);
+
+    private:
+        friend class LiteralFilter;
+        std::vector<std::pair<tp::UInt, tp::UInt>> m_ranges;
+        tp::UInt m_next = 0;
+    };
+
+    LiteralFilter(const tp::SearchParams &params, bool orOp, tp::FileType fileType);
+
+    // Only when the literals cover the query: one of any positive param for AND, or one of every param for OR.
+    bool isActive() const { return !m_literals.empty(); }
+    // Returns false when the data cannot be filtered, so all its rows must be matched.
+    bool find(std::string_view data, Hits &hits) const;
+
+private:
+    static std::optional<std::string> getLiteral(const tp::SearchParam &param, tp::FileType fileType);
+    void findEach(std::string_view data, Hits &hits) const;
+
+    struct Literal
+    {
+        std::string text;
+        bool matchCase = true;
+        std::optional<AsciiFoldSearcher> foldSearcher;
+    };
+
+    bool m_json = false;
+    std::vector<Literal> m_literals;
+    // With many literals of an OR query, they are all found in a single pass over the data.
+    AhoCorasick m_automaton;
+};
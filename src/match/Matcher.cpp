@@ -10,24 +10,159 @@
 void Matcher::setParam(const tp::SearchParam &param)
 {
     m_matchers.clear();
+    m_subStrings.clear();
     makeMatcher(param, m_matchers);
+    m_found.assign(m_matchers.size(), std::nullopt);
+    makePlan();
 }
 
 void Matcher::setParams(const tp::SearchParams &params, bool orOp)
 {
     m_matchers.clear();
+    m_subStrings.clear();
     makeMatchers(params, m_matchers);
     m_orOp = orOp;
+    makePlan();
+
+    // The params are identified by their index, which is the one of their matcher when all were made.
+    const auto subStringCount = std::count_if(params.begin(), params.end(), &SubStringSet::canAdd);
+    if ((m_matchers.size() == params.size()) && (static_cast<tp::UInt>(subStringCount) >= AhoCorasick::s_minPatterns))
+    {
+        for (tp::UInt i = 0; i < params.size(); ++i)
+        {
+            if (SubStringSet::canAdd(params[i]))
+            {
+                m_subStrings.add(i, params[i]);
+                // Found before evaluating the plan.
+                m_plan[i].cost = 0;
+            }
+        }
+        m_subStrings.build();
+    }
+    m_found.assign(m_matchers.size(), std::nullopt);
+}
+
+void Matcher::makePlan()
+{
+    m_plan.clear();
+    m_plannedRows = 0;
+    for (tp::UInt i = 0; i < m_matchers.size(); ++i)
+    {
+        auto &step = m_plan.emplace_back();
+        step.idx = i;
+        step.type = m_matchers[i]->getType();
+        step.cost = (step.type == tp::SearchType::Regex) ? 8 : ((step.type == tp::SearchType::Range) ? 2 : 1);
+        step.anyColumn = !m_matchers[i]->hasColumn();
+    }
 }
 
-bool Matcher::match(const std::string &text) const
+void Matcher::sortPlan(tp::UInt columnCount) const
+{
+    const auto rank = [this, columnCount](const Step &step)
+    {
+        // The params not evaluated yet are taken as matching half of the rows.
+        const double matchRate((step.matched + 1.0) / (step.evaluated + 2.0));
+        const double endRate(m_orOp ? matchRate : (1.0 - matchRate));
+        return (step.anyColumn ? (step.cost * columnCount) : step.cost) / endRate;
+    };
+    std::stable_sort(
+        m_plan.begin(),
+        m_plan.end(),
+        [&rank](const Step &lhs, const Step &rhs) { return (rank(lhs) < rank(rhs)); });
+}
+
+template <typename T>
+std::optional<bool> Matcher::matchParam(T &matcher, const tp::RowData &rowData, const std::optional<bool> &found)
+{
+    bool matched(false);
+    if (matcher.hasColumn())
+    {
+        if (matcher.getColumn() >= rowData.size())
+        {
+            LOG_ERR("Matcher column {} is bigger than row columns {}", matcher.getColumn(), rowData.size() - 1);
+            return std::nullopt;
+        }
+        matched = found.has_value() ? found.value() : matcher.match(rowData[matcher.getColumn()]);
+    }
+    else if (found.has_value())
+    {
+        matched = found.value();
+    }
+    else
+    {
+        matched = std::any_of(
+            rowData.begin(),
+            rowData.end(),
+            [&matcher](const std::string &text) { return matcher.match(text); });
+    }
+    return (matched != matcher.notOp());
+}
+
+std::optional<bool> Matcher::matchStep(const Step &step, const tp::RowData &rowData) const
+{
+    auto &matcher = *m_matchers[step.idx];
+    const auto &found = m_found[step.idx];
+    switch (step.type)
+    {
+    case tp::SearchType::SubString:
+        return matchParam(static_cast<SubStringMatcher &>(matcher), rowData, found);
+    case tp::SearchType::Regex:
+        return matchParam(static_cast<RegexMatcher &>(matcher), rowData, found);
+    case tp::SearchType::Range:
+        return matchParam(static_cast<RangeMatcher &>(matcher), rowData, found);
+    default:
+        return matchParam(matcher, rowData, found);
+    }
+}
+
+bool Matcher::match(std::string_view text) const
 {
     return match(m_matchers, m_orOp, text);
 }
 
 bool Matcher::matchInRow(const tp::RowData &rowData) const
 {
-    return matchInRow(m_matchers, m_orOp, rowData);
+    if (m_plan.empty())
+    {
+        return false;
+    }
+
+    if (!m_subStrings.empty())
+    {
+        m_subStrings.findInRow(rowData, m_found);
+    }
+
+    // An AND ends at the first param not matched, and an OR at the first one matched, so the params most likely
+    // to end it for the lowest cost are evaluated first.
+    if ((m_plannedRows++ % s_sortPlanRows) == 0)
+    {
+        sortPlan(rowData.size());
+    }
+
+    for (auto &step : m_plan)
+    {
+        const auto matched = matchStep(step, rowData);
+        if (!matched.has_value())
+        {
+            // The param of a missing column is not matched.
+            if (!m_orOp)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        ++step.evaluated;
+        if (matched.value())
+        {
+            ++step.matched;
+        }
+        if (matched.value() == m_orOp)
+        {
+            return m_orOp;
+        }
+    }
+    return !m_orOp;
 }
 
 void Matcher::makeMatcher(const tp::SearchParam &param, Matchers &matchers)
@@ -57,7 +192,7 @@ void Matcher::makeMatchers(const tp::SearchParams &params, Matchers &matchers)
     }
 }
 
-bool Matcher::match(const Matchers &matchers, bool orOp, const std::string &text)
+bool Matcher::match(const Matchers &matchers, bool orOp, std::string_view text)
 {
     std::uint32_t cnt(0);
 
@@ -82,16 +217,26 @@ bool Matcher::match(const Matchers &matchers, bool orOp, const std::string &text
 }
 
 bool Matcher::matchInRow(const Matchers &matchers, bool orOp, const tp::RowData &rowData)
+{
+    return matchInRow(matchers, orOp, rowData, std::vector<std::optional<bool>>(matchers.size()));
+}
+
+bool Matcher::matchInRow(
+    const Matchers &matchers,
+    bool orOp,
+    const tp::RowData &rowData,
+    const std::vector<std::optional<bool>> &found)
 {
     std::uint32_t cnt(0);
 
-    for (const auto &matcher : matchers)
+    for (tp::UInt i = 0; i < matchers.size(); ++i)
     {
+        const auto &matcher = matchers[i];
         if (matcher->hasColumn())
         {
             if (matcher->getColumn() < rowData.size())
             {
-                bool matched = matcher->match(rowData[matcher->getColumn()]);
+                bool matched = found[i].has_value() ? found[i].value() : matcher->match(rowData[matcher->getColumn()]);
                 if (matcher->notOp())
                     matched = !matched;
                 if (matched)
@@ -107,10 +252,10 @@ bool Matcher::matchInRow(const Matchers &matchers, bool orOp, const tp::RowData
         }
         else
         {
-            bool matched(false);
-            for (const auto &columnData : rowData)
+            bool matched(found[i].value_or(false));
+            for (tp::UInt col = 0; !found[i].has_value() && (col < rowData.size()); ++col)
             {
-                if (matcher->match(columnData))
+                if (matcher->match(rowData[col]))
                 {
                     matched = true;
                     break;
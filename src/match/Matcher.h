@@ -4,6 +4,7 @@
 #pragma once
 
 #include "BaseMatcher.h"
+#include "SubStringSet.h"
 
 class Matcher
 {
@@ -12,16 +13,48 @@ public:
 
     void setParam(const tp::SearchParam &param);
     void setParams(const tp::SearchParams &params, bool orOp);
-    bool match(const std::string &text) const;
+    bool match(std::string_view text) const;
     bool matchInRow(const tp::RowData &rowData) const;
 
     static void makeMatcher(const tp::SearchParam &param, Matchers &matchers);
     static void makeMatchers(const tp::SearchParams &params, Matchers &matchers);
-    static bool match(const Matchers &matchers, bool orOp, const std::string &text);
+    static bool match(const Matchers &matchers, bool orOp, std::string_view text);
     static bool matchInRow(const Matchers &matchers, bool orOp, const tp::RowData &rowData);
 
 private:
+    // A param of the plan, with the rows it was evaluated on, and how many of them it matched.
+    struct Step
+    {
+        tp::UInt idx = 0;
+        tp::SearchType type = tp::SearchType::None;
+        // Estimated cost of evaluating it on a column, relative to a substring search.
+        tp::UInt cost = 0;
+        bool anyColumn = false;
+        tp::UInt evaluated = 0;
+        tp::UInt matched = 0;
+    };
+
+    static bool matchInRow(
+        const Matchers &matchers,
+        bool orOp,
+        const tp::RowData &rowData,
+        const std::vector<std::optional<bool>> &found);
+    void makePlan();
+    // Sorts the plan by the cost and the selectivity of the params, estimated for rows of the given columns.
+    void sortPlan(tp::UInt columnCount) const;
+    std::optional<bool> matchStep(const Step &step, const tp::RowData &rowData) const;
+    // The kernel of each matcher type, whose match is called without virtual dispatch.
+    template <typename T>
+    static std::optional<bool> matchParam(T &matcher, const tp::RowData &rowData, const std::optional<bool> &found);
+
+    static constexpr tp::UInt s_sortPlanRows = 1024;
 
     Matchers m_matchers;
     bool m_orOp = false;
+    // With many substring params, they are all found in a single pass over the row.
+    SubStringSet m_subStrings;
+    mutable std::vector<std::optional<bool>> m_found;
+    // Order in which the params are evaluated, which is sorted again as the rows are matched.
+    mutable std::vector<Step> m_plan;
+    mutable tp::UInt m_plannedRows = 0;
 };
@@ -3,10 +3,61 @@
 
 #include "pch.h"
 #include "RangeMatcher.h"
+#include <charconv>
+
+namespace
+{
+
+std::string_view trimmed(std::string_view text)
+{
+    const auto isSpace = [](char c) { return (c == ' ') || ((c >= '\t') && (c <= '\r')); };
+    while (!text.empty() && isSpace(text.front()))
+    {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back()))
+    {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Parses the whole text as a number, like QString does, but without converting it.
+template <typename T> std::optional<T> parseNumber(std::string_view text)
+{
+    text = trimmed(text);
+    if ((text.size() > 1) && (text.front() == '+'))
+    {
+        text.remove_prefix(1);
+    }
+
+    T value{};
+#if !defined(__cpp_lib_to_chars)
+    // Without the floating point std::from_chars, it's parsed with the C locale by QByteArray.
+    // It must be in the else branch, otherwise from_chars would still be instantiated for the double.
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        bool ok(false);
+        value = QByteArray::fromRawData(text.data(), static_cast<int>(text.size())).toDouble(&ok);
+        return ok ? std::optional<T>(value) : std::nullopt;
+    }
+    else
+#endif
+    {
+        const char *end = text.data() + text.size();
+        const auto res = std::from_chars(text.data(), end, value);
+        if ((res.ec != std::errc()) || (res.ptr != end))
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+}
+
+} // namespace
 
 RangeMatcher::RangeMatcher(const tp::SearchParam &param) : BaseMatcher(param)
 {
-    static const QRegularExpression rxRangeSppliter("^\\s*(.*?)\\s*->\\s*(.*?)\\s*$");
     if (!param.column.has_value())
     {
         LOG_ERR("No column specified for range matcher");
@@ -18,29 +69,86 @@ RangeMatcher::RangeMatcher(const tp::SearchParam &param) : BaseMatcher(param)
         return;
     }
 
-    auto m = rxRangeSppliter.match(param.pattern.c_str());
+    const auto [from, to] = splitBounds(param.pattern);
+    setBounds(from, to);
+}
+
+std::pair<std::string, std::string> RangeMatcher::splitBounds(const std::string &pattern)
+{
+    static const QRegularExpression rxRangeSppliter("^\\s*(.*?)\\s*->\\s*(.*?)\\s*$");
+    auto m = rxRangeSppliter.match(pattern.c_str());
     if (m.hasMatch())
     {
-        const auto from = m.captured(1);
-        const auto to = m.captured(2);
+        return std::make_pair(m.captured(1).toStdString(), m.captured(2).toStdString());
+    }
+    return std::make_pair(pattern, std::string());
+}
+
+void RangeMatcher::setBounds(const std::string &from, const std::string &to)
+{
+    const auto &column = m_param.column.value();
 
-        if (!from.isEmpty())
+    bool valid(true);
+    switch (column.type)
+    {
+    case tp::ColumnType::Int:
+        m_kernel = Kernel::Int;
+        m_intRange = Range<std::int64_t>(parseNumber<std::int64_t>(from), parseNumber<std::int64_t>(to));
+        valid = m_intRange.isValid();
+        break;
+    case tp::ColumnType::UInt:
+        m_kernel = Kernel::UInt;
+        m_uintRange = Range<std::uint64_t>(parseNumber<std::uint64_t>(from), parseNumber<std::uint64_t>(to));
+        valid = m_uintRange.isValid();
+        break;
+    case tp::ColumnType::Float:
+        m_kernel = Kernel::Float;
+        m_floatRange = Range<double>(parseNumber<double>(from), parseNumber<double>(to));
+        valid = m_floatRange.isValid();
+        break;
+    case tp::ColumnType::Time:
+        m_kernel = Kernel::Time;
+        m_timeParser.setFormat(column.format);
+        m_intRange = Range<std::int64_t>(m_timeParser.parse(from), m_timeParser.parse(to));
+        valid = m_intRange.isValid();
+        break;
+    default:
+        m_kernel = Kernel::Variant;
+        if (!from.empty())
         {
-            m_from = utl::toVariant(param.column.value(), from);
+            m_from = utl::toVariant(column, QString::fromStdString(from));
         }
-
-        if (!to.isEmpty())
+        if (!to.empty())
         {
-            m_to = utl::toVariant(param.column.value(), to);
+            m_to = utl::toVariant(column, QString::fromStdString(to));
         }
+        break;
     }
-    else
+
+    if (!valid)
+    {
+        LOG_WAR("Invalid range '{}' for the column '{}'", m_param.pattern, column.name);
+    }
+}
+
+bool RangeMatcher::match(std::string_view text)
+{
+    switch (m_kernel)
     {
-        m_from = utl::toVariant(param.column.value(), param.pattern.c_str());
+    case Kernel::Int:
+        return m_intRange.contains(parseNumber<std::int64_t>(text));
+    case Kernel::UInt:
+        return m_uintRange.contains(parseNumber<std::uint64_t>(text));
+    case Kernel::Float:
+        return m_floatRange.contains(parseNumber<double>(text));
+    case Kernel::Time:
+        return m_intRange.contains(m_timeParser.parse(text));
+    default:
+        return matchVariant(text);
     }
 }
 
-bool RangeMatcher::match(const std::string &text)
+bool RangeMatcher::matchVariant(std::string_view text) const
 {
     if (text.empty())
         return false;
@@ -52,7 +160,7 @@ bool RangeMatcher::match(const std::string &text)
     if (!res)
         return false;
 
-    const auto val(utl::toVariant(m_param.column.value(), text.c_str()));
+    const auto val(utl::toVariant(m_param.column.value(), QString::fromUtf8(text.data(), text.size())));
     if (val.isValid() && !val.isNull())
     {
         if (validFrom)
@@ -65,4 +173,4 @@ bool RangeMatcher::match(const std::string &text)
     }
 
     return false;
-}
\ No newline at end of file
+}
@@ -4,14 +4,55 @@
 #pragma once
 
 #include "BaseMatcher.h"
+#include "TimeParser.h"
 
-class RangeMatcher : public BaseMatcher
+// Matches the values of the column in the range "from -> to", where any of the bounds may be omitted.
+// The numbers and times are parsed straight from the text and compared with the bounds parsed once,
+// while the other types are compared as variants.
+class RangeMatcher final : public BaseMatcher
 {
 public:
     RangeMatcher(const tp::SearchParam &param);
-    bool match(const std::string &text) override;
+    bool match(std::string_view text) override;
+    // Splits the pattern into its bounds, which are empty when omitted.
+    static std::pair<std::string, std::string> splitBounds(const std::string &pattern);
 
 private:
+    template <typename T> class Range
+    {
+    public:
+        Range() = default;
+        Range(std::optional<T> from, std::optional<T> to) : m_from(from), m_to(to) {}
+        bool isValid() const { return (m_from.has_value() || m_to.has_value()); }
+        bool contains(const std::optional<T> &value) const
+        {
+            return value.has_value() && isValid() && (!m_from.has_value() || (value.value() >= m_from.value())) &&
+                   (!m_to.has_value() || (value.value() <= m_to.value()));
+        }
+
+    private:
+        std::optional<T> m_from;
+        std::optional<T> m_to;
+    };
+
+    enum class Kernel
+    {
+        Variant,
+        Int,
+        UInt,
+        Float,
+        Time
+    };
+
+    void setBounds(const std::string &from, const std::string &to);
+    bool matchVariant(std::string_view text) const;
+
+    Kernel m_kernel = Kernel::Variant;
+    Range<std::int64_t> m_intRange;
+    Range<std::uint64_t> m_uintRange;
+    Range<double> m_floatRange;
+    // The times are compared as nanoseconds since the epoch, in m_intRange.
+    TimeParser m_timeParser;
     QVariant m_from;
     QVariant m_to;
 };
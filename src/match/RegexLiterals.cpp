@@ -0,0 +1,349 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "RegexLiterals.h"
+#include "AsciiFoldSearcher.h"
+#include <cstring>
+
+namespace
+{
+
+bool isAsciiAlnum(char c)
+{
+    return ((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'));
+}
+
+bool isDigit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+// Size of the utf-8 character starting with the byte.
+tp::UInt getCharSize(char c)
+{
+    const auto b = static_cast<unsigned char>(c);
+    return (b < 0xC0) ? 1 : (b < 0xE0) ? 2 : (b < 0xF0) ? 3 : 4;
+}
+
+} // namespace
+
+std::vector<std::string> RegexLiterals::extract(std::string_view pattern, bool matchCase)
+{
+    std::vector<std::string> literals;
+    std::string current;
+    // Size of the last atom added to the current literal, which is taken back when it turns out to be optional.
+    tp::UInt lastAtomSize = 0;
+
+    const auto addAtom = [&](std::string_view atom)
+    {
+        current.append(atom);
+        lastAtomSize = atom.size();
+    };
+    const auto split = [&]()
+    {
+        if (!current.empty())
+        {
+            literals.push_back(std::move(current));
+            current.clear();
+        }
+        lastAtomSize = 0;
+    };
+    // A quantifier that allows zero repetitions makes its atom optional, and any other makes it repeated.
+    const auto quantify = [&](bool optional, tp::UInt pos)
+    {
+        if (optional)
+        {
+            current.resize(current.size() - lastAtomSize);
+        }
+        split();
+        // Lazy or possessive quantifier.
+        return ((pos < pattern.size()) && ((pattern[pos] == '?') || (pattern[pos] == '+'))) ? (pos + 1) : pos;
+    };
+
+    tp::UInt pos = 0;
+    while (pos < pattern.size())
+    {
+        const char c = pattern[pos];
+        switch (c)
+        {
+        case '\\':
+        {
+            if (pos + 1 >= pattern.size())
+            {
+                return {};
+            }
+
+            const char escaped = pattern[pos + 1];
+            if (escaped == 'Q')
+            {
+                // Quoted until \E, or the end of the pattern.
+                const auto end = std::min(pattern.find("\\E", pos + 2), pattern.size());
+                for (tp::UInt i = pos + 2; i < end; i += getCharSize(pattern[i]))
+                {
+                    if (isLiteral(pattern[i], matchCase))
+                        addAtom(pattern.substr(i, getCharSize(pattern[i])));
+                    else
+                        split();
+                }
+                pos = std::min(end + 2, pattern.size());
+            }
+            else if (
+                (static_cast<unsigned char>(escaped) < 0x80) && !isAsciiAlnum(escaped) && isLiteral(escaped, matchCase))
+            {
+                addAtom(pattern.substr(pos + 1, 1));
+                pos += 2;
+            }
+            else
+            {
+                // Character class, assertion, back reference or a character given by its code.
+                split();
+                pos = skipEscape(pattern, pos);
+            }
+            break;
+        }
+        case '(':
+        {
+            // Verbs and inline options, which may change how the rest of the pattern matches.
+            if ((pos + 1 < pattern.size()) && (pattern[pos + 1] == '*'))
+            {
+                return {};
+            }
+            if ((pos + 1 < pattern.size()) && (pattern[pos + 1] == '?'))
+            {
+                tp::UInt i = pos + 2;
+                while ((i < pattern.size()) && (isAsciiAlnum(pattern[i]) || (pattern[i] == '-') || (pattern[i] == '^')))
+                {
+                    ++i;
+                }
+                if ((i > pos + 2) && (i < pattern.size()) && (pattern[i] == ')'))
+                {
+                    return {};
+                }
+            }
+
+            split();
+            pos = skipGroup(pattern, pos);
+            if (pos == std::string_view::npos)
+            {
+                return {};
+            }
+            break;
+        }
+        case '[':
+            split();
+            pos = skipClass(pattern, pos);
+            if (pos == std::string_view::npos)
+            {
+                return {};
+            }
+            break;
+        case '|':
+        case ')':
+            return {};
+        case '.':
+        case '^':
+        case '$':
+            split();
+            ++pos;
+            break;
+        case '*':
+        case '?':
+            pos = quantify(true, pos + 1);
+            break;
+        case '+':
+            pos = quantify(false, pos + 1);
+            break;
+        case '{':
+        {
+            // A quantifier is {n}, {n,}, {n,m} or {,m}, and anything else is a literal brace.
+            tp::UInt i = pos + 1;
+            while ((i < pattern.size()) && (isDigit(pattern[i]) || (pattern[i] == ',') || (pattern[i] == ' ')))
+            {
+                ++i;
+            }
+            const auto bounds = pattern.substr(pos + 1, i - pos - 1);
+            if ((i < pattern.size()) && (pattern[i] == '}') && std::any_of(bounds.begin(), bounds.end(), isDigit))
+            {
+                const auto min = bounds.substr(0, bounds.find(','));
+                const bool optional(
+                    std::none_of(min.begin(), min.end(), [](char d) { return isDigit(d) && (d != '0'); }));
+                pos = quantify(optional, i + 1);
+            }
+            else
+            {
+                addAtom(pattern.substr(pos, 1));
+                ++pos;
+            }
+            break;
+        }
+        default:
+        {
+            const tp::UInt size(std::min(getCharSize(c), pattern.size() - pos));
+            if (isLiteral(c, matchCase))
+                addAtom(pattern.substr(pos, size));
+            else
+                split();
+            pos += size;
+            break;
+        }
+        }
+    }
+    split();
+
+    return literals;
+}
+
+std::optional<std::string> RegexLiterals::getLongest(std::string_view pattern, bool matchCase)
+{
+    std::optional<std::string> longest;
+    for (auto &literal : extract(pattern, matchCase))
+    {
+        if (!longest.has_value() || (literal.size() > longest->size()))
+        {
+            longest = std::move(literal);
+        }
+    }
+    return longest;
+}
+
+tp::UInt RegexLiterals::skipClass(std::string_view pattern, tp::UInt pos)
+{
+    tp::UInt i = pos + 1;
+    if ((i < pattern.size()) && (pattern[i] == '^'))
+    {
+        ++i;
+    }
+    // A closing bracket at the start is a member of the class.
+    if ((i < pattern.size()) && (pattern[i] == ']'))
+    {
+        ++i;
+    }
+
+    while (i < pattern.size())
+    {
+        if (pattern[i] == '\\')
+        {
+            i += 2;
+        }
+        else if ((pattern[i] == '[') && (i + 1 < pattern.size()) && (pattern[i + 1] == ':'))
+        {
+            const auto end = pattern.find(":]", i + 2);
+            if (end == std::string_view::npos)
+            {
+                return std::string_view::npos;
+            }
+            i = end + 2;
+        }
+        else if (pattern[i] == ']')
+        {
+            return i + 1;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+tp::UInt RegexLiterals::skipGroup(std::string_view pattern, tp::UInt pos)
+{
+    tp::UInt depth = 0;
+    tp::UInt i = pos;
+    while (i < pattern.size())
+    {
+        switch (pattern[i])
+        {
+        case '\\':
+            if ((i + 1 < pattern.size()) && (pattern[i + 1] == 'Q'))
+            {
+                const auto end = pattern.find("\\E", i + 2);
+                i = (end == std::string_view::npos) ? pattern.size() : (end + 2);
+            }
+            else
+            {
+                i += 2;
+            }
+            break;
+        case '[':
+            i = skipClass(pattern, i);
+            if (i == std::string_view::npos)
+            {
+                return i;
+            }
+            break;
+        case '(':
+            ++depth;
+            ++i;
+            break;
+        case ')':
+            ++i;
+            if (--depth == 0)
+            {
+                return i;
+            }
+            break;
+        default:
+            ++i;
+            break;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+tp::UInt RegexLiterals::skipEscape(std::string_view pattern, tp::UInt pos)
+{
+    const char escaped = pattern[pos + 1];
+    tp::UInt i = pos + 2;
+
+    // The escapes followed by a delimited argument, as \x{41}, \p{L}, \g{1} or \k<name>.
+    if ((i < pattern.size()) && (std::strchr("xopPgkNu", escaped) != nullptr))
+    {
+        const char open = pattern[i];
+        const char close = (open == '{') ? '}' : (open == '<') ? '>' : (open == '\'') ? '\'' : '\0';
+        if (close != '\0')
+        {
+            const auto end = pattern.find(close, i + 1);
+            return (end == std::string_view::npos) ? pattern.size() : (end + 1);
+        }
+    }
+
+    if (escaped == 'c')
+    {
+        // Control character, as \cA.
+        return std::min(i + 1, pattern.size());
+    }
+    if (escaped == 'x')
+    {
+        for (tp::UInt n = 0; (n < 2) && (i < pattern.size()) && std::isxdigit(static_cast<unsigned char>(pattern[i]));
+             ++n)
+        {
+            ++i;
+        }
+    }
+    else if (isDigit(escaped) || (escaped == 'g'))
+    {
+        // Back reference or octal code.
+        while ((i < pattern.size()) && (isDigit(pattern[i]) || (pattern[i] == '-')))
+        {
+            ++i;
+        }
+    }
+
+    return i;
+}
+
+bool RegexLiterals::isLiteral(char c, bool matchCase)
+{
+    if (matchCase)
+    {
+        return true;
+    }
+
+    // The unicode case folding matches 'k' with the kelvin sign and 's' with the long s.
+    const char upper = AsciiFoldSearcher::fold(c);
+    return (static_cast<unsigned char>(c) < 0x80) && (upper != 'K') && (upper != 'S');
+}
@@ -0,0 +1,22 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+// Conservative analysis of a regex pattern, which finds the literals that every match must contain.
+// Only the top level sequence is analyzed: the groups, classes, escapes and optional atoms split the literals.
+// A pattern with a top level alternation, or with inline options, has no required literals.
+class RegexLiterals
+{
+public:
+    // Without MatchCase, only the ascii letters are taken as literals, except those that have a non ascii
+    // letter in the unicode case folding, which are 'k' and 's'.
+    static std::vector<std::string> extract(std::string_view pattern, bool matchCase);
+    static std::optional<std::string> getLongest(std::string_view pattern, bool matchCase);
+
+private:
+    static tp::UInt skipClass(std::string_view pattern, tp::UInt pos);
+    static tp::UInt skipGroup(std::string_view pattern, tp::UInt pos);
+    static tp::UInt skipEscape(std::string_view pattern, tp::UInt pos);
+    static bool isLiteral(char c, bool matchCase);
+};
@@ -3,22 +3,43 @@
 
 #include "pch.h"
 #include "RegexMatcher.h"
+#include "RegexLiterals.h"
 
-RegexMatcher::RegexMatcher(const tp::SearchParam &param) : BaseMatcher(param), m_rx(param.pattern.c_str(), getOpts())
+RegexMatcher::RegexMatcher(const tp::SearchParam &param) : BaseMatcher(param), m_rx(param.pattern, matchCase(), false)
 {
-}
+    if (!m_rx.isValid())
+    {
+        return;
+    }
 
-QRegularExpression::PatternOptions RegexMatcher::getOpts()
-{
-    QRegularExpression::PatternOptions opts = QRegularExpression::DontCaptureOption;
-    if (!matchCase())
+    auto literals = RegexLiterals::extract(param.pattern, matchCase());
+    std::sort(
+        literals.begin(),
+        literals.end(),
+        [](const std::string &lhs, const std::string &rhs) { return (lhs.size() > rhs.size()); });
+
+    // A single character is found in too many rows to be worth searching.
+    for (const auto &literal : literals)
     {
-        opts |= QRegularExpression::CaseInsensitiveOption;
+        if (literal.size() > 1)
+        {
+            tp::SearchParam literalParam;
+            literalParam.type = tp::SearchType::SubString;
+            literalParam.flags.set(tp::SearchFlag::MatchCase, matchCase());
+            literalParam.pattern = literal;
+            m_literalMatchers.emplace_back(literalParam);
+        }
     }
-    return opts;
 }
 
-bool RegexMatcher::match(const std::string &text)
+bool RegexMatcher::match(std::string_view text)
 {
-    return m_rx.match(text.c_str()).hasMatch();
+    for (auto &literalMatcher : m_literalMatchers)
+    {
+        if (!literalMatcher.match(text))
+        {
+            return false;
+        }
+    }
+    return m_rx.match(text);
 }
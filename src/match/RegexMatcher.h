@@ -4,14 +4,17 @@
 #pragma once
 
 #include "BaseMatcher.h"
+#include "SubStringMatcher.h"
+#include "Utf8Regex.h"
 
-class RegexMatcher : public BaseMatcher
+class RegexMatcher final : public BaseMatcher
 {
 public:
     RegexMatcher(const tp::SearchParam &param);
-    QRegularExpression::PatternOptions getOpts();
-    bool match(const std::string &text) override;
+    bool match(std::string_view text) override;
 
 private:
-    const QRegularExpression m_rx;
+    const Utf8Regex m_rx;
+    // The literals that every match contains, longest first, which are searched before running the regex.
+    std::vector<SubStringMatcher> m_literalMatchers;
 };
@@ -4,16 +4,30 @@
 #include "pch.h"
 #include "SubStringMatcher.h"
 
-SubStringMatcher::SubStringMatcher(const tp::SearchParam &param)
-    : BaseMatcher(param),
-      m_textToSearch(matchCase() ? m_param.pattern : utl::toUpper(m_param.pattern))
+SubStringMatcher::SubStringMatcher(const tp::SearchParam &param) : BaseMatcher(param), m_textToSearch(m_param.pattern)
 {
+    if (!matchCase())
+    {
+        if (AsciiFoldSearcher::isAscii(m_textToSearch))
+        {
+            m_foldSearcher.emplace(m_textToSearch);
+        }
+        else
+        {
+            m_utf8FoldSearcher.emplace(m_textToSearch);
+            m_unicodeTextToSearch = QString::fromStdString(m_textToSearch);
+        }
+    }
 }
 
-bool SubStringMatcher::match(const std::string &text)
+bool SubStringMatcher::match(std::string_view text)
 {
     if (matchCase())
-        return (text.find(m_textToSearch) != std::string::npos);
+        return (text.find(m_textToSearch) != std::string_view::npos);
+    else if (m_foldSearcher.has_value())
+        return (m_foldSearcher->find(text) != std::string_view::npos);
+    else if (const auto found = m_utf8FoldSearcher->contains(text); found.has_value())
+        return found.value();
     else
-        return (utl::toUpper(text).find(m_textToSearch) != std::string::npos);
+        return QString::fromUtf8(text.data(), text.size()).contains(m_unicodeTextToSearch, Qt::CaseInsensitive);
 }
\ No newline at end of file
@@ -4,13 +4,20 @@
 #pragma once
 
 #include "BaseMatcher.h"
+#include "AsciiFoldSearcher.h"
+#include "Utf8FoldSearcher.h"
 
-class SubStringMatcher : public BaseMatcher
+class SubStringMatcher final : public BaseMatcher
 {
 public:
     SubStringMatcher(const tp::SearchParam &param);
-    bool match(const std::string &text) override;
+    bool match(std::string_view text) override;
 
 private:
     const std::string m_textToSearch;
+    // Without MatchCase, an ascii pattern is searched by folding the ascii letters, and any other pattern
+    // by folding the unicode characters. QString is left for the text that is not valid utf-8.
+    std::optional<AsciiFoldSearcher> m_foldSearcher;
+    std::optional<Utf8FoldSearcher> m_utf8FoldSearcher;
+    QString m_unicodeTextToSearch;
 };
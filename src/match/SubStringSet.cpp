@@ -0,0 +1,60 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "SubStringSet.h"
+
+bool SubStringSet::canAdd(const tp::SearchParam &param)
+{
+    return (param.type == tp::SearchType::SubString) && !param.pattern.empty() &&
+           (param.flags.has(tp::SearchFlag::MatchCase) || AsciiFoldSearcher::isAscii(param.pattern));
+}
+
+void SubStringSet::add(tp::UInt idx, const tp::SearchParam &param)
+{
+    m_automaton.add(param.pattern, param.flags.has(tp::SearchFlag::MatchCase));
+
+    auto &entry = m_entries.emplace_back();
+    entry.idx = idx;
+    if (param.column.has_value())
+    {
+        entry.column = static_cast<tp::UInt>(param.column->idx);
+    }
+}
+
+void SubStringSet::build()
+{
+    m_automaton.build();
+}
+
+void SubStringSet::clear()
+{
+    m_automaton.clear();
+    m_entries.clear();
+}
+
+void SubStringSet::findInRow(const tp::RowData &rowData, std::vector<std::optional<bool>> &found) const
+{
+    for (const auto &entry : m_entries)
+    {
+        found[entry.idx] = false;
+    }
+
+    tp::UInt remaining(m_entries.size());
+    for (tp::UInt col = 0; (col < rowData.size()) && (remaining > 0); ++col)
+    {
+        m_automaton.scan(
+            rowData[col],
+            [&](tp::UInt id, tp::UInt)
+            {
+                const auto &entry = m_entries[id];
+                auto &entryFound = found[entry.idx];
+                if (!entryFound.value() && (!entry.column.has_value() || (entry.column.value() == col)))
+                {
+                    entryFound = true;
+                    --remaining;
+                }
+                return (remaining > 0);
+            });
+    }
+}
@@ -0,0 +1,36 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include "AhoCorasick.h"
+
+// Substring params searched together, in a single pass over each column of a row.
+// Each param is identified by an index given by the caller, as its position in a list of params.
+class SubStringSet
+{
+public:
+    // Whether the param is a substring that the set can find. A non ascii pattern without MatchCase is
+    // compared with the unicode case folding, which is left to its matcher.
+    static bool canAdd(const tp::SearchParam &param);
+
+    void add(tp::UInt idx, const tp::SearchParam &param);
+    void build();
+    void clear();
+    bool empty() const { return m_automaton.empty(); }
+
+    // Sets found[idx] of every added param to whether it is in its column, or in any column when it has none.
+    // The other items of found are not changed.
+    void findInRow(const tp::RowData &rowData, std::vector<std::optional<bool>> &found) const;
+
+private:
+    struct Entry
+    {
+        tp::UInt idx = 0;
+        std::optional<tp::UInt> column;
+    };
+
+    AhoCorasick m_automaton;
+    // Indexed by the pattern id.
+    std::vector<Entry> m_entries;
+};
@@ -0,0 +1,137 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "Utf8FoldSearcher.h"
+#include "AsciiFoldSearcher.h"
+
+namespace
+{
+
+// Only the ascii letters fold to ascii letters, so the other ascii bytes always have the same value.
+bool isCaseless(char c)
+{
+    const auto byte = static_cast<unsigned char>(c);
+    return (byte < 0x80) && !(((byte | 0x20) >= 'a') && ((byte | 0x20) <= 'z'));
+}
+
+// Decodes the code point at the position and moves it forward. Returns false on an invalid sequence.
+bool decode(std::string_view text, tp::UInt &pos, char32_t &cp)
+{
+    const auto lead = static_cast<unsigned char>(text[pos]);
+    tp::UInt len(0);
+    char32_t min(0);
+    if (lead < 0xC2)
+    {
+        return false;
+    }
+    else if (lead < 0xE0)
+    {
+        len = 2;
+        cp = lead & 0x1F;
+        min = 0x80;
+    }
+    else if (lead < 0xF0)
+    {
+        len = 3;
+        cp = lead & 0x0F;
+        min = 0x800;
+    }
+    else if (lead < 0xF5)
+    {
+        len = 4;
+        cp = lead & 0x07;
+        min = 0x10000;
+    }
+    else
+    {
+        return false;
+    }
+
+    if ((pos + len) > text.size())
+    {
+        return false;
+    }
+    for (tp::UInt i = 1; i < len; ++i)
+    {
+        const auto byte = static_cast<unsigned char>(text[pos + i]);
+        if ((byte & 0xC0) != 0x80)
+        {
+            return false;
+        }
+        cp = (cp << 6) | (byte & 0x3F);
+    }
+
+    if ((cp < min) || (cp > 0x10FFFF) || ((cp >= 0xD800) && (cp <= 0xDFFF)))
+    {
+        return false;
+    }
+    pos += len;
+    return true;
+}
+
+} // namespace
+
+Utf8FoldSearcher::Utf8FoldSearcher(std::string_view pattern)
+{
+    m_valid = fold(pattern, m_pattern);
+    m_hasNonAscii = std::any_of(m_pattern.begin(), m_pattern.end(), [](char32_t cp) { return (cp >= 0x80); });
+
+    tp::UInt runStart(0);
+    for (tp::UInt i = 0; i <= pattern.size(); ++i)
+    {
+        if ((i == pattern.size()) || !isCaseless(pattern[i]))
+        {
+            if ((i - runStart) > m_anchor.size())
+            {
+                m_anchor = pattern.substr(runStart, i - runStart);
+            }
+            runStart = i + 1;
+        }
+    }
+}
+
+std::optional<bool> Utf8FoldSearcher::contains(std::string_view text) const
+{
+    if (!m_valid)
+    {
+        return std::nullopt;
+    }
+
+    if ((m_hasNonAscii && AsciiFoldSearcher::isAscii(text)) ||
+        (!m_anchor.empty() && (text.find(m_anchor) == std::string_view::npos)))
+    {
+        return false;
+    }
+
+    thread_local std::u32string folded;
+    if (!fold(text, folded))
+    {
+        return std::nullopt;
+    }
+    return (std::u32string_view(folded).find(m_pattern) != std::u32string_view::npos);
+}
+
+bool Utf8FoldSearcher::fold(std::string_view text, std::u32string &folded)
+{
+    folded.clear();
+    tp::UInt pos(0);
+    while (pos < text.size())
+    {
+        const auto byte = static_cast<unsigned char>(text[pos]);
+        if (byte < 0x80)
+        {
+            folded.push_back(((byte >= 'A') && (byte <= 'Z')) ? (byte | 0x20) : byte);
+            ++pos;
+            continue;
+        }
+
+        char32_t cp(0);
+        if (!decode(text, pos, cp))
+        {
+            return false;
+        }
+        folded.push_back(static_cast<char32_t>(QChar::toCaseFolded(cp)));
+    }
+    return true;
+}
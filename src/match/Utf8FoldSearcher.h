@@ -0,0 +1,26 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+// Substring search that ignores the case of the unicode characters in utf-8 text.
+// The code points are decoded and compared by their simple case folding, the same one used by QString, so a
+// search allocates nothing once the buffer of the thread has grown.
+class Utf8FoldSearcher
+{
+public:
+    Utf8FoldSearcher(std::string_view pattern);
+
+    // Returns nullopt when the pattern or the text is not valid utf-8, which QString decodes differently.
+    std::optional<bool> contains(std::string_view text) const;
+
+private:
+    static bool fold(std::string_view text, std::u32string &folded);
+
+    std::u32string m_pattern;
+    bool m_valid = false;
+    // No ascii character folds to a non-ascii one, so such a pattern can only be in a text with non-ascii bytes.
+    bool m_hasNonAscii = false;
+    // The longest run of bytes without case in the pattern, which must be in the text for a match.
+    std::string m_anchor;
+};
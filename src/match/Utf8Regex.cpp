@@ -0,0 +1,309 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "Utf8Regex.h"
+
+#if defined(HAVE_PCRE2)
+
+#include <atomic>
+#include <pcre2.h>
+
+class RegexImp
+{
+public:
+    RegexImp(const std::string &pattern, bool matchCase, bool capture) : m_pattern(pattern)
+    {
+        std::uint32_t opts = PCRE2_UTF;
+#if defined(PCRE2_MATCH_INVALID_UTF)
+        // Without it, pcre2_match fails with an error on a row with invalid utf-8, so its valid parts
+        // could never match.
+        opts |= PCRE2_MATCH_INVALID_UTF;
+#endif
+        if (!matchCase)
+        {
+            opts |= PCRE2_CASELESS;
+        }
+        if (!capture)
+        {
+            opts |= PCRE2_NO_AUTO_CAPTURE;
+        }
+
+        int errorCode = 0;
+        PCRE2_SIZE errorOffset = 0;
+        m_code = pcre2_compile(
+            reinterpret_cast<PCRE2_SPTR>(pattern.data()),
+            pattern.size(),
+            opts,
+            &errorCode,
+            &errorOffset,
+            nullptr);
+        if (m_code == nullptr)
+        {
+            PCRE2_UCHAR message[256];
+            pcre2_get_error_message(errorCode, message, sizeof(message));
+            m_errorString = fmt::format("{} at offset {}", reinterpret_cast<const char *>(message), errorOffset);
+            return;
+        }
+
+        // Without JIT support, the patterns are still matched by the interpreter.
+        const int jitRes = pcre2_jit_compile(m_code, PCRE2_JIT_COMPLETE);
+        if (jitRes != 0)
+        {
+            LOG_INF("Regex '{}' is not JIT compiled: {}", pattern, jitRes);
+        }
+
+        pcre2_pattern_info(m_code, PCRE2_INFO_CAPTURECOUNT, &m_captureCount);
+    }
+
+    ~RegexImp()
+    {
+        if (m_code != nullptr)
+            pcre2_code_free(m_code);
+    }
+
+    bool isValid() const { return (m_code != nullptr); }
+
+    std::string getErrorString() const { return m_errorString; }
+
+    bool match(std::string_view text, std::vector<std::string> *groups) const
+    {
+        if (m_code == nullptr)
+        {
+            return false;
+        }
+
+        pcre2_match_data *matchData = getMatchData(m_captureCount + 1);
+        pcre2_match_context *matchContext = getMatchContext();
+        int res = pcre2_match(
+            m_code,
+            reinterpret_cast<PCRE2_SPTR>(text.data()),
+            text.size(),
+            0,
+            0,
+            matchData,
+            matchContext);
+#if defined(PCRE2_NO_JIT)
+        // A pattern that needs more stack than the JIT stack has is still matched by the interpreter.
+        if (res == PCRE2_ERROR_JIT_STACKLIMIT)
+        {
+            res = pcre2_match(
+                m_code,
+                reinterpret_cast<PCRE2_SPTR>(text.data()),
+                text.size(),
+                0,
+                PCRE2_NO_JIT,
+                matchData,
+                matchContext);
+        }
+#endif
+        if (res < 0)
+        {
+            if ((res != PCRE2_ERROR_NOMATCH) && !m_matchErrorLogged.exchange(true))
+            {
+                PCRE2_UCHAR message[256];
+                pcre2_get_error_message(res, message, sizeof(message));
+                LOG_WAR("Regex '{}' failed to match: {}", m_pattern, reinterpret_cast<const char *>(message));
+            }
+            return false;
+        }
+
+        if (groups != nullptr)
+        {
+            const PCRE2_SIZE *ovector = pcre2_get_ovector_pointer(matchData);
+            groups->resize(m_captureCount + 1);
+            for (std::uint32_t i = 0; i < groups->size(); ++i)
+            {
+                auto &group = (*groups)[i];
+                if ((i < static_cast<std::uint32_t>(res)) && (ovector[2 * i] != PCRE2_UNSET))
+                {
+                    group.assign(text.data() + ovector[2 * i], ovector[2 * i + 1] - ovector[2 * i]);
+                }
+                else
+                {
+                    group.clear();
+                }
+            }
+        }
+
+        return true;
+    }
+
+    int getGroupNumber(const std::string &name) const
+    {
+        if (m_code == nullptr)
+        {
+            return -1;
+        }
+        const int number = pcre2_substring_number_from_name(m_code, reinterpret_cast<PCRE2_SPTR>(name.c_str()));
+        return (number < 0) ? -1 : number;
+    }
+
+private:
+    // The match data is kept per thread, so the matching allocates nothing and can be done by many threads.
+    static pcre2_match_data *getMatchData(std::uint32_t pairs)
+    {
+        struct MatchData
+        {
+            ~MatchData()
+            {
+                if (data != nullptr)
+                    pcre2_match_data_free(data);
+            }
+            pcre2_match_data *data = nullptr;
+            std::uint32_t pairs = 0;
+        };
+        thread_local MatchData matchData;
+
+        if (pairs > matchData.pairs)
+        {
+            if (matchData.data != nullptr)
+                pcre2_match_data_free(matchData.data);
+            matchData.data = pcre2_match_data_create(pairs, nullptr);
+            matchData.pairs = pairs;
+        }
+        return matchData.data;
+    }
+
+    // The JIT stack is kept per thread as well. The default one, 32 KB on the machine stack, is too small for
+    // the patterns that backtrack over long rows.
+    static pcre2_match_context *getMatchContext()
+    {
+        struct MatchContext
+        {
+            MatchContext()
+            {
+                context = pcre2_match_context_create(nullptr);
+                stack = pcre2_jit_stack_create(32 * 1024, 1024 * 1024, nullptr);
+                if ((context != nullptr) && (stack != nullptr))
+                    pcre2_jit_stack_assign(context, nullptr, stack);
+            }
+            ~MatchContext()
+            {
+                if (stack != nullptr)
+                    pcre2_jit_stack_free(stack);
+                if (context != nullptr)
+                    pcre2_match_context_free(context);
+            }
+            pcre2_match_context *context = nullptr;
+            pcre2_jit_stack *stack = nullptr;
+        };
+        thread_local MatchContext matchContext;
+        return matchContext.context;
+    }
+
+    std::string m_pattern;
+    pcre2_code *m_code = nullptr;
+    std::uint32_t m_captureCount = 0;
+    std::string m_errorString;
+    // The errors are logged once, as they would be repeated for every row.
+    mutable std::atomic<bool> m_matchErrorLogged{false};
+};
+
+#else
+
+class RegexImp
+{
+public:
+    RegexImp(const std::string &pattern, bool matchCase, bool capture)
+        : m_rx(QString::fromStdString(pattern), getOpts(matchCase, capture))
+    {
+        m_groupNames = m_rx.namedCaptureGroups();
+    }
+
+    bool isValid() const { return m_rx.isValid(); }
+
+    std::string getErrorString() const { return utl::toStr(m_rx.errorString()); }
+
+    bool match(std::string_view text, std::vector<std::string> *groups) const
+    {
+        const QRegularExpressionMatch match = m_rx.match(QString::fromUtf8(text.data(), text.size()));
+        if (!match.hasMatch())
+        {
+            return false;
+        }
+
+        if (groups != nullptr)
+        {
+            groups->resize(m_rx.captureCount() + 1);
+            for (tp::UInt i = 0; i < groups->size(); ++i)
+            {
+                (*groups)[i] = match.captured(i).toStdString();
+            }
+        }
+
+        return true;
+    }
+
+    int getGroupNumber(const std::string &name) const
+    {
+        return name.empty() ? -1 : static_cast<int>(m_groupNames.indexOf(QString::fromStdString(name)));
+    }
+
+private:
+    static QRegularExpression::PatternOptions getOpts(bool matchCase, bool capture)
+    {
+        QRegularExpression::PatternOptions opts = QRegularExpression::NoPatternOption;
+        if (!matchCase)
+        {
+            opts |= QRegularExpression::CaseInsensitiveOption;
+        }
+        if (!capture)
+        {
+            opts |= QRegularExpression::DontCaptureOption;
+        }
+        return opts;
+    }
+
+    QRegularExpression m_rx;
+    QStringList m_groupNames;
+};
+
+#endif
+
+Utf8Regex::Utf8Regex(const std::string &pattern, bool matchCase, bool capture)
+{
+    setPattern(pattern, matchCase, capture);
+}
+
+Utf8Regex::~Utf8Regex()
+{
+    delete m_imp;
+}
+
+void Utf8Regex::setPattern(const std::string &pattern, bool matchCase, bool capture)
+{
+    delete m_imp;
+    m_pattern = pattern;
+    m_imp = new RegexImp(m_pattern, matchCase, capture);
+}
+
+bool Utf8Regex::isValid() const
+{
+    return (m_imp == nullptr) || m_imp->isValid();
+}
+
+std::string Utf8Regex::getErrorString() const
+{
+    return (m_imp != nullptr) ? m_imp->getErrorString() : std::string();
+}
+
+bool Utf8Regex::match(std::string_view text) const
+{
+    return (m_imp != nullptr) && m_imp->match(text, nullptr);
+}
+
+bool Utf8Regex::match(std::string_view text, std::vector<std::string> &groups) const
+{
+    if (m_imp == nullptr)
+    {
+        groups.clear();
+        return false;
+    }
+    return m_imp->match(text, &groups);
+}
+
+int Utf8Regex::getGroupNumber(const std::string &name) const
+{
+    return (m_imp != nullptr) ? m_imp->getGroupNumber(name) : -1;
+}
@@ -0,0 +1,37 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+class RegexImp;
+
+// Regular expression matched on utf-8 text.
+// When PCRE2 was built, it's JIT compiled and matched directly on the bytes. Otherwise it's matched by
+// QRegularExpression, which converts the text to utf-16 on every match.
+// The matching can be done by many threads at once.
+class Utf8Regex
+{
+public:
+    Utf8Regex() = default;
+    Utf8Regex(const std::string &pattern, bool matchCase = true, bool capture = true);
+    Utf8Regex(const Utf8Regex &) = delete;
+    Utf8Regex &operator=(const Utf8Regex &) = delete;
+    ~Utf8Regex();
+
+    // Without capture, the groups are not captured, which makes the matching faster.
+    void setPattern(const std::string &pattern, bool matchCase = true, bool capture = true);
+    const std::string &getPattern() const { return m_pattern; }
+    bool isValid() const;
+    std::string getErrorString() const;
+
+    bool match(std::string_view text) const;
+    // Gives all the groups on a match, where the group 0 is the whole match and the ones that didn't participate
+    // are empty. The strings of the groups are reused, so the same vector should be given on every match.
+    bool match(std::string_view text, std::vector<std::string> &groups) const;
+    // Number of a named group, or -1 when there is no such group.
+    int getGroupNumber(const std::string &name) const;
+
+private:
+    std::string m_pattern;
+    RegexImp *m_imp = nullptr;
+};
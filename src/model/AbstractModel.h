@@ -18,6 +18,21 @@ public:
     virtual tp::UInt columnCount() const = 0;
     virtual tp::UInt rowCount() const = 0;
     virtual tp::SInt getRowNum(tp::SInt row) const = 0;
+    // Hints that the rows are going to be read soon, in the given order, so they can be loaded in background.
+    virtual void prefetchRows(const std::vector<tp::SInt> &rows) {}
+    // Returns the first row at or after the time, which is in the format of the time column, or -1 if unknown.
+    virtual tp::SInt findRowByTime(const std::string &time) const { return -1; }
+
+    // The first column of the Time type, by which the rows are navigated, or nullptr.
+    const tp::Column *getTimeColumn() const
+    {
+        const auto &columns = getColumns();
+        const auto it = std::find_if(
+            columns.begin(),
+            columns.end(),
+            [](const tp::Column &column) { return (column.type == tp::ColumnType::Time); });
+        return (it != columns.end()) ? &(*it) : nullptr;
+    }
 
 signals:
     void modelConfigured() const;
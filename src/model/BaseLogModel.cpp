@@ -3,13 +3,24 @@
 
 #include "pch.h"
 #include "BaseLogModel.h"
+#include "Settings.h"
+#include "LiteralFilter.h"
+#include "RangeMatcher.h"
+
+// Rows tried from the start of each block to sample its time, as some rows may have none (e.g. a stack trace).
+constexpr tp::UInt g_timeSampleRows(8);
 
 BaseLogModel::BaseLogModel(FileConf::Ptr conf, QObject *parent)
     : AbstractModel(parent),
       m_conf(conf),
       m_fileName(conf->getFileName()),
-      m_ifs(InFileStream::make(m_fileName))
+      m_indexCache(m_fileName, conf->getFileType()),
+      m_ifs(InFileStream::make(m_fileName)),
+      m_fileWatcher(FileWatcher::make(m_fileName)),
+      m_tailReader(TailReader::make(m_fileName)),
+      m_chunkCache(Settings::getChunkCacheSize() * 1024 * 1024)
 {
+    m_compressed.store(m_ifs->isCompressed());
 }
 
 BaseLogModel::~BaseLogModel()
@@ -24,6 +35,14 @@ BaseLogModel::~BaseLogModel()
     {
         m_ifs->close();
     }
+
+    LOG_INF("Chunk cache of '{}': {} hits, {} misses", m_fileName, m_chunkCache.getHits(), m_chunkCache.getMisses());
+    LOG_INF(
+        "Tail reader of '{}': {:.2f} MB read with {} read calls and {} seeks",
+        m_fileName,
+        m_tailReader->getReadBytes() / (1024.0 * 1024.0),
+        m_tailReader->getReadCalls(),
+        m_tailReader->getSeekCalls());
 }
 
 const std::string &BaseLogModel::getFileName() const
@@ -33,21 +52,25 @@ const std::string &BaseLogModel::getFileName() const
 
 tp::SInt BaseLogModel::getRow(tp::SInt row, tp::RowData &rowData) const
 {
-    const std::lock_guard<std::mutex> lock(m_ifsMutex);
-
     if ((-1L < row) && (row < m_rowCount.load()))
     {
-        if (!m_cachedChunkRows.contains(row))
+        // The rows are usually cached, either by a previous call or by the prefetch thread, so the file lock is
+        // taken only when they must be loaded.
+        auto chunkRows = m_chunkCache.get(row);
+        if (!chunkRows)
         {
-            loadChunkRowsByRow(row, m_cachedChunkRows);
-            if (!m_cachedChunkRows.contains(row))
+            const std::lock_guard<std::mutex> lock(m_ifsMutex);
+            auto newChunkRows = std::make_shared<ChunkRows>();
+            if (!loadBlockRowsByRow(row, *newChunkRows) || !newChunkRows->contains(row))
             {
                 LOG_ERR("Row {} not found in the cache", row);
                 return -1;
             }
+            chunkRows = newChunkRows;
+            m_chunkCache.put(std::move(newChunkRows));
         }
 
-        if (parseRow(m_cachedChunkRows.get(row), rowData))
+        if (parseRow(chunkRows->get(row), rowData))
         {
             return row;
         }
@@ -74,14 +97,23 @@ const tp::Columns &BaseLogModel::getColumns() const
 void BaseLogModel::startSearch(const tp::SearchParams &params, bool orOp)
 {
     stopSearch();
-    m_matcher.setParams(params, orOp);
-    m_searching.store(true);
+    m_searchParams = params;
+    m_searchOrOp = orOp;
+    {
+        const std::lock_guard<std::mutex> lock(m_indexedMutex);
+        m_indexedRows.clear();
+        m_searching.store(true);
+    }
     m_searchThread = std::thread(&BaseLogModel::search, this);
 }
 
 void BaseLogModel::stopSearch()
 {
-    m_searching.store(false);
+    {
+        const std::lock_guard<std::mutex> lock(m_indexedMutex);
+        m_searching.store(false);
+    }
+    m_indexedCv.notify_all();
     if (m_searchThread.joinable())
     {
         m_searchThread.join();
@@ -93,78 +125,680 @@ bool BaseLogModel::isSearching() const
     return m_searching.load();
 }
 
+void BaseLogModel::startFind(const tp::SearchParams &params, bool orOp, tp::SInt fromRow, bool backward)
+{
+    stopFind();
+    m_finding.store(true);
+    m_findThread = std::thread(&BaseLogModel::find, this, params, orOp, fromRow, backward);
+}
+
+void BaseLogModel::stopFind()
+{
+    m_finding.store(false);
+    if (m_findThread.joinable())
+    {
+        m_findThread.join();
+    }
+}
+
+void BaseLogModel::startCount(const tp::SearchParams &params, bool orOp)
+{
+    stopCount();
+    m_counting.store(true);
+    m_countThread = std::thread(&BaseLogModel::count, this, params, orOp);
+}
+
+void BaseLogModel::stopCount()
+{
+    m_counting.store(false);
+    if (m_countThread.joinable())
+    {
+        m_countThread.join();
+    }
+}
+
 void BaseLogModel::search()
 {
     LOG_INF("Starting to search");
 
-    ChunkRows chunkRows;
-    tp::RowData rowData;
+    const tp::UInt generation(m_generation.load());
+    SearchCache::Entry entry{m_searchParams, m_searchOrOp, generation};
     tp::UInt row(0);
 
+    // A repeated search starts after the rows searched before, and a narrower one matches only the rows found by
+    // the broader one.
+    auto candidates = m_searchCache.find(m_searchParams, m_searchOrOp, generation);
+    if (candidates && SearchCache::isSame(*candidates, m_searchParams, m_searchOrOp))
+    {
+        entry.rows = candidates->rows;
+        row = candidates->searchedRows;
+        candidates.reset();
+
+        auto rowsPtr = std::make_shared<tp::SIntList>();
+        entry.rows.appendTo(*rowsPtr);
+        if (!rowsPtr->empty())
+        {
+            emit valueFound(rowsPtr);
+        }
+        LOG_INF("Reusing the {} rows found in the first {} rows", entry.rows.size(), row);
+    }
+    else if (candidates)
+    {
+        LOG_INF(
+            "Refining the {} rows found in the first {} rows",
+            candidates->rows.size(),
+            candidates->searchedRows);
+    }
+
+    // Only the blocks around the time ranges of the search are searched, besides the rows whose times were not
+    // sampled yet.
+    tp::UInt checkedRows(0);
+    const auto timeRows = findSearchTimeRows(checkedRows);
+    if (timeRows.has_value())
+    {
+        LOG_INF(
+            "The time ranges of the search are in {} row ranges of the first {} rows",
+            timeRows->size(),
+            checkedRows);
+    }
+
+    // Adds the blocks with the rows [firstRow, lastRow] of the chunk.
+    const auto addBlocks = [](std::vector<Chunk> &chunks, const Chunk &chunk, tp::UInt firstRow, tp::UInt lastRow)
+    {
+        const Chunk first(chunk.getBlock(firstRow));
+        const Chunk last(chunk.getBlock(lastRow));
+        // The ranges may share a block, which must not be searched twice.
+        if (!chunks.empty() && (chunks.back().getEndPos() > first.getStartPos()))
+        {
+            const Chunk prev(chunks.back());
+            chunks.back() = Chunk(prev.getStartPos(), last.getEndPos(), prev.getFistRow(), last.getLastRow());
+        }
+        else
+        {
+            chunks.emplace_back(first.getStartPos(), last.getEndPos(), first.getFistRow(), last.getLastRow());
+        }
+    };
+
+    // The first pass searches all the rows indexed so far, and the next ones only those published since then.
+    std::optional<tp::UInt> indexedRowCount;
+    std::vector<MappedFile::Ptr> maps;
+
     while (m_searching.load())
     {
         QElapsedTimer timer;
         timer.start();
-        qint64 searchTime(0);
 
-        tp::UInt startingRow(row);
+        // Only the ranges of the chunks are taken, so the lock is not held while searching.
+        std::vector<Chunk> chunks;
+        tp::UInt rowCount(0);
+        {
+            const std::lock_guard<std::mutex> lock(m_ifsMutex);
+            rowCount = std::min<tp::UInt>(indexedRowCount.value_or(m_rowCount.load()), m_rowCount.load());
+            auto chunk = std::lower_bound(m_chunks.begin(), m_chunks.end(), row, Chunk::compareRows);
+            for (; chunk != m_chunks.end(); ++chunk)
+            {
+                // The chunk holding the row is read from the block of the row, as the rows before it were searched
+                // by the previous pass.
+                const tp::UInt firstRow(std::max(row, chunk->getFistRow()));
+                if (!timeRows.has_value() || (firstRow >= checkedRows))
+                {
+                    addBlocks(chunks, *chunk, firstRow, chunk->getLastRow());
+                    continue;
+                }
 
-        tp::SharedSIntList rowsPtr = std::make_shared<tp::SIntList>();
+                auto range = std::upper_bound(
+                    timeRows->begin(),
+                    timeRows->end(),
+                    firstRow,
+                    [](tp::UInt r, const std::pair<tp::UInt, tp::UInt> &rows) { return (r < rows.second); });
+                for (; (range != timeRows->end()) && (range->first <= chunk->getLastRow()); ++range)
+                {
+                    const tp::UInt endRow(std::min({range->second, checkedRows, chunk->getLastRow() + 1}));
+                    if (std::max(range->first, firstRow) < endRow)
+                    {
+                        addBlocks(chunks, *chunk, std::max(range->first, firstRow), endRow - 1);
+                    }
+                }
+                if (chunk->getLastRow() >= checkedRows)
+                {
+                    addBlocks(chunks, *chunk, std::max(firstRow, checkedRows), chunk->getLastRow());
+                }
+            }
+        }
 
-        while ((row < m_rowCount.load()) && m_searching.load(std::memory_order_relaxed))
+        if (!chunks.empty())
         {
+            const tp::UInt startingRow(row);
+            row = searchChunks(chunks, row, rowCount, candidates.get(), entry.rows, maps);
+            LOG_INF("Searched {} rows in {} ms", row - startingRow, timer.elapsed());
+        }
+        // The candidates only cover the rows searched before, which are all searched by the first pass.
+        candidates.reset();
+
+        searchingProgressChanged(100);
+
+        // Sleeps until the indexer publishes new rows, which are searched as soon as they are indexed.
+        std::unique_lock<std::mutex> lock(m_indexedMutex);
+        m_indexedCv.wait(lock, [this]() { return (!m_searching.load() || !m_indexedRows.empty()); });
+        for (const auto &range : m_indexedRows)
+        {
+            indexedRowCount = std::max(indexedRowCount.value_or(0), range.second);
+        }
+        m_indexedRows.clear();
+    }
+
+    // The rows searched after a reload were not searched with the ones before it.
+    entry.searchedRows = row;
+    if ((row > 0) && (m_generation.load() == generation))
+    {
+        m_searchCache.put(std::move(entry));
+    }
+}
+
+tp::UInt BaseLogModel::searchChunks(
+    const std::vector<Chunk> &chunks,
+    tp::UInt fromRow,
+    tp::UInt rowCount,
+    const SearchCache::Entry *candidates,
+    RowSet &foundRows,
+    std::vector<MappedFile::Ptr> &maps)
+{
+    const tp::UInt workerCount(std::min<tp::UInt>(std::max(std::thread::hardware_concurrency(), 1U), chunks.size()));
+
+    // Each worker reads through its own file handle, so they don't wait for each other.
+    std::vector<InFileStream::Ptr> files;
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        for (tp::UInt i = 0; i < workerCount; ++i)
+        {
+            files.push_back(m_ifs->reopen());
+        }
+    }
+
+    // The chunks are searched in any order, but their results are emitted in row order.
+    std::vector<std::optional<tp::SIntList>> results(chunks.size());
+    std::mutex resultsMutex;
+    std::condition_variable resultsCv;
+    std::atomic<tp::UInt> nextChunk(0);
+
+    // Only the rows containing the required literals are parsed and matched.
+    const LiteralFilter filter(m_searchParams, m_searchOrOp, m_conf->getFileType());
+    std::atomic<tp::UInt> parsedRows(0);
+    // The rows before it are searched only when found by the candidates.
+    const tp::UInt candidatesEnd(candidates ? candidates->searchedRows : 0);
+
+    const auto searchWorker = [&](InFileStream &ifs, MappedFile::Ptr &map)
+    {
+        Matcher matcher;
+        matcher.setParams(m_searchParams, m_searchOrOp);
+        tp::RowData rowData;
+        LiteralFilter::Hits hits;
+
+        for (tp::UInt i = nextChunk++; (i < chunks.size()) && m_searching.load(); i = nextChunk++)
+        {
+            tp::SIntList found;
+            tp::UInt chunkParsedRows(0);
+            ChunkRows chunkRows(chunks[i]);
+            // The chunks searched before without any row found are not even read.
+            if ((chunks[i].getLastRow() < candidatesEnd) &&
+                (candidates->rows.count(chunks[i].getFistRow(), chunks[i].getLastRow() + 1) == 0))
             {
-                const std::lock_guard<std::mutex> lock(m_ifsMutex);
-                if (!loadChunkRowsByRow(row, chunkRows))
                 {
-                    break;
+                    const std::lock_guard<std::mutex> lock(resultsMutex);
+                    results[i] = std::move(found);
+                }
+                resultsCv.notify_one();
+                continue;
+            }
+
+            if (readChunkData(chunkRows, ifs, map))
+            {
+                loadChunkRows(chunkRows);
+                const std::string_view data(chunkRows.getData());
+                // The candidates are usually fewer than the rows with the literals.
+                const bool useFilter(
+                    filter.isActive() && (chunks[i].getLastRow() >= candidatesEnd) && filter.find(data, hits));
+
+                for (const auto &[currRow, rawText] : chunkRows.data())
+                {
+                    if (!m_searching.load(std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                    if (currRow < fromRow)
+                    {
+                        continue;
+                    }
+                    if ((currRow < candidatesEnd) && !candidates->rows.contains(currRow))
+                    {
+                        continue;
+                    }
+                    if (useFilter)
+                    {
+                        const tp::UInt rowStart(rawText.data() - data.data());
+                        if (!hits.inRow(rowStart, rowStart + rawText.size()))
+                        {
+                            continue;
+                        }
+                    }
+
+                    ++chunkParsedRows;
+                    parseRow(rawText, rowData);
+                    if (matcher.matchInRow(rowData))
+                    {
+                        found.push_back(currRow);
+                    }
+                    rowData.clear();
+                }
+            }
+            else
+            {
+                LOG_ERR("Cannot search the chunk at pos {}", chunks[i].getStartPos());
+            }
+            parsedRows += chunkParsedRows;
+
+            {
+                const std::lock_guard<std::mutex> lock(resultsMutex);
+                results[i] = std::move(found);
+            }
+            resultsCv.notify_one();
+        }
+    };
+
+    maps.resize(std::max<tp::UInt>(maps.size(), workerCount));
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (tp::UInt i = 0; i < workerCount; ++i)
+    {
+        workers.emplace_back(searchWorker, std::ref(*files[i]), std::ref(maps[i]));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    tp::UInt mergedChunks(0);
+    tp::UInt nextRow(fromRow);
+    tp::SharedSIntList rowsPtr = std::make_shared<tp::SIntList>();
+
+    while ((mergedChunks < chunks.size()) && m_searching.load())
+    {
+        {
+            std::unique_lock<std::mutex> lock(resultsMutex);
+            resultsCv.wait_for(
+                lock,
+                std::chrono::milliseconds(100),
+                [&]() { return results[mergedChunks].has_value(); });
+
+            for (; (mergedChunks < chunks.size()) && results[mergedChunks].has_value(); ++mergedChunks)
+            {
+                auto &found = results[mergedChunks].value();
+                for (const auto foundRow : found)
+                {
+                    foundRows.add(foundRow);
+                }
+                rowsPtr->insert(rowsPtr->end(), found.begin(), found.end());
+                results[mergedChunks].reset();
+                nextRow = chunks[mergedChunks].getLastRow() + 1;
+            }
+        }
+
+        if (timer.hasExpired(1000))
+        {
+            searchingProgressChanged((nextRow * 100) / rowCount);
+            if (!rowsPtr->empty())
+            {
+                emit valueFound(rowsPtr);
+                rowsPtr = std::make_shared<tp::SIntList>();
+            }
+            timer.restart();
+        }
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    if (!rowsPtr->empty())
+    {
+        emit valueFound(rowsPtr);
+    }
+
+    if (filter.isActive())
+    {
+        LOG_INF("The literal prefilter let {} of {} rows be parsed", parsedRows.load(), nextRow - fromRow);
+    }
+
+    return nextRow;
+}
+
+void BaseLogModel::find(const tp::SearchParams &params, bool orOp, tp::SInt fromRow, bool backward)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // The ranges are taken from the row, in the order they are searched. The next row is usually close, so the
+    // chunk with the row is read from its block rather than as a whole: forward up to its end, and backward one
+    // block at a time.
+    std::vector<Chunk> chunks;
+    InFileStream::Ptr ifs;
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        if (backward)
+        {
+            const tp::UInt endRow(std::max<tp::SInt>(fromRow, 0));
+            auto chunk = std::lower_bound(m_chunks.begin(), m_chunks.end(), endRow, Chunk::compareRows);
+            if ((chunk != m_chunks.end()) && (chunk->getFistRow() < endRow))
+            {
+                for (tp::UInt row(endRow - 1);;)
+                {
+                    const Chunk block(chunk->getBlock(row));
+                    chunks.push_back(block);
+                    if (block.getFistRow() == chunk->getFistRow())
+                    {
+                        break;
+                    }
+                    row = block.getFistRow() - 1;
+                }
+            }
+            for (auto it = std::make_reverse_iterator(chunk); it != m_chunks.rend(); ++it)
+            {
+                chunks.emplace_back(it->getStartPos(), it->getEndPos(), it->getFistRow(), it->getLastRow());
+            }
+        }
+        else
+        {
+            const tp::UInt row(fromRow + 1);
+            auto chunk = std::lower_bound(m_chunks.begin(), m_chunks.end(), row, Chunk::compareRows);
+            if (chunk != m_chunks.end())
+            {
+                chunks.push_back(chunk->getTail(row));
+                ++chunk;
+            }
+            for (; chunk != m_chunks.end(); ++chunk)
+            {
+                chunks.emplace_back(chunk->getStartPos(), chunk->getEndPos(), chunk->getFistRow(), chunk->getLastRow());
+            }
+        }
+        ifs = m_ifs->reopen();
+    }
+
+    Matcher matcher;
+    matcher.setParams(params, orOp);
+    const LiteralFilter filter(params, orOp, m_conf->getFileType());
+    LiteralFilter::Hits hits;
+    MappedFile::Ptr map;
+    tp::RowData rowData;
+    tp::SInt foundRow(-1);
+    tp::UInt searchedRanges(0);
+
+    for (const auto &chunk : chunks)
+    {
+        if (!m_finding.load())
+        {
+            return;
+        }
+
+        ChunkRows chunkRows(chunk);
+        if (!readChunkData(chunkRows, *ifs, map))
+        {
+            LOG_ERR("Cannot search the range at pos {}", chunk.getStartPos());
+            continue;
+        }
+        ++searchedRanges;
+
+        loadChunkRows(chunkRows);
+        const std::string_view data(chunkRows.getData());
+        const bool useFilter(filter.isActive() && filter.find(data, hits));
+
+        const auto matchRow = [&](const ChunkRows::ChunkRowsData &rowRawText)
+        {
+            const auto &[currRow, rawText] = rowRawText;
+            if (backward ? (static_cast<tp::SInt>(currRow) >= fromRow) : (static_cast<tp::SInt>(currRow) <= fromRow))
+            {
+                return false;
+            }
+            if (useFilter)
+            {
+                const tp::UInt rowStart(rawText.data() - data.data());
+                if (!hits.inRow(rowStart, rowStart + rawText.size()))
+                {
+                    return false;
                 }
             }
 
+            rowData.clear();
+            parseRow(rawText, rowData);
+            return matcher.matchInRow(rowData);
+        };
+
+        const auto &rows = chunkRows.data();
+        if (backward)
+        {
+            const auto it = std::find_if(rows.rbegin(), rows.rend(), matchRow);
+            if (it != rows.rend())
+            {
+                foundRow = it->first;
+                break;
+            }
+        }
+        else
+        {
+            const auto it = std::find_if(rows.begin(), rows.end(), matchRow);
+            if (it != rows.end())
+            {
+                foundRow = it->first;
+                break;
+            }
+        }
+    }
+
+    LOG_INF("Found row {} after searching {} ranges in {} ms", foundRow, searchedRanges, timer.elapsed());
+    emit rowFound(foundRow);
+}
+
+void BaseLogModel::count(const tp::SearchParams &params, bool orOp)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto histogram = std::make_shared<Histogram>();
+    std::vector<Chunk> chunks;
+    std::vector<InFileStream::Ptr> files;
+    TimeParser parser;
+    tp::UInt timeColumn(0);
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        for (const auto &chunk : m_chunks)
+        {
+            chunks.emplace_back(chunk.getStartPos(), chunk.getEndPos(), chunk.getFistRow(), chunk.getLastRow());
+        }
+
+        const tp::UInt workerCount(std::max(std::thread::hardware_concurrency(), 1U));
+        for (tp::UInt i = 0; i < std::min<tp::UInt>(workerCount, chunks.size()); ++i)
+        {
+            files.push_back(m_ifs->reopen());
+        }
+
+        // The buckets are of time when the rows have times, with a size for the time span of the log.
+        const auto timeRange = m_timeIndex.hasColumn() ? m_timeIndex.getTimeRange() : std::nullopt;
+        if (timeRange.has_value())
+        {
+            parser = m_timeIndex.getParser();
+            timeColumn = m_timeIndex.getColumn();
+            histogram->byTime = true;
+            histogram->bucketSize = Histogram::getTimeBucketSize(timeRange->second - timeRange->first);
+        }
+        else
+        {
+            histogram->bucketSize = (m_rowCount.load() / Histogram::s_maxBuckets) + 1;
+        }
+    }
+
+    // Each worker counts the rows of its chunks apart, so only the counts of the buckets are merged at the end.
+    const LiteralFilter filter(params, orOp, m_conf->getFileType());
+    std::vector<Histogram::Counts> partialCounts(files.size());
+    std::vector<tp::UInt> untimedCounts(files.size(), 0);
+    std::atomic<tp::UInt> nextChunk(0);
+    std::atomic<tp::UInt> countedChunks(0);
+
+    const auto countWorker = [&](tp::UInt worker)
+    {
+        Matcher matcher;
+        matcher.setParams(params, orOp);
+        MappedFile::Ptr map;
+        tp::RowData rowData;
+        LiteralFilter::Hits hits;
+        auto &counts = partialCounts[worker];
+
+        for (tp::UInt i = nextChunk++; (i < chunks.size()) && m_counting.load(); i = nextChunk++, ++countedChunks)
+        {
+            ChunkRows chunkRows(chunks[i]);
+            if (!readChunkData(chunkRows, *files[worker], map))
+            {
+                LOG_ERR("Cannot count the chunk at pos {}", chunks[i].getStartPos());
+                continue;
+            }
+
+            loadChunkRows(chunkRows);
+            const std::string_view data(chunkRows.getData());
+            const bool useFilter(filter.isActive() && filter.find(data, hits));
+
             for (const auto &[currRow, rawText] : chunkRows.data())
             {
-                parseRow(rawText, rowData);
-                if (m_matcher.matchInRow(rowData))
+                if (!m_counting.load(std::memory_order_relaxed))
                 {
-                    rowsPtr->push_back(currRow);
+                    return;
+                }
+                if (useFilter)
+                {
+                    const tp::UInt rowStart(rawText.data() - data.data());
+                    if (!hits.inRow(rowStart, rowStart + rawText.size()))
+                    {
+                        continue;
+                    }
                 }
 
                 rowData.clear();
-                row = currRow + 1;
+                parseRow(rawText, rowData);
+                if (!matcher.matchInRow(rowData))
+                {
+                    continue;
+                }
+
+                if (!histogram->byTime)
+                {
+                    Histogram::add(counts, Histogram::getBucket(currRow, histogram->bucketSize), currRow);
+                    continue;
+                }
+
+                const auto time = (timeColumn < rowData.size()) ? parser.parse(rowData[timeColumn]) : std::nullopt;
+                if (time.has_value())
+                {
+                    Histogram::add(counts, Histogram::getBucket(time.value(), histogram->bucketSize), currRow);
+                }
+                else
+                {
+                    ++untimedCounts[worker];
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(files.size());
+    for (tp::UInt i = 0; i < files.size(); ++i)
+    {
+        workers.emplace_back(countWorker, i);
+    }
+
+    while (m_counting.load() && (countedChunks.load() < chunks.size()))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        countingProgressChanged((countedChunks.load() * 100) / chunks.size());
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    countingProgressChanged(100);
+
+    if (!m_counting.load())
+    {
+        return;
+    }
+
+    Histogram::Counts counts;
+    for (tp::UInt i = 0; i < partialCounts.size(); ++i)
+    {
+        Histogram::merge(counts, partialCounts[i]);
+        histogram->untimedCount += untimedCounts[i];
+    }
+    histogram->setCounts(counts);
+
+    LOG_INF("Counted {} rows in {} buckets in {} ms", histogram->count, histogram->buckets.size(), timer.elapsed());
+    emit histogramFound(histogram);
+}
+
+void BaseLogModel::prefetchRows(const std::vector<tp::SInt> &rows)
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_prefetchMutex);
+        m_prefetchRows = rows;
+        ++m_prefetchRequest;
+    }
+    m_prefetchCv.notify_one();
+}
+
+void BaseLogModel::prefetch()
+{
+    std::vector<tp::SInt> rows;
+
+    while (m_prefetching.load())
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_prefetchMutex);
+            m_prefetchCv.wait(lock, [this]() { return !m_prefetchRows.empty() || !m_prefetching.load(); });
+            rows.swap(m_prefetchRows);
+            m_prefetchRows.clear();
+        }
+
+        // At most a quarter of the cache is filled by a request, so the rows being viewed are not evicted.
+        const auto request(m_prefetchRequest.load());
+        const tp::UInt maxBytes(m_chunkCache.getMaxBytes() / 4);
+        tp::UInt loadedBytes(0);
+        std::pair<tp::SInt, tp::SInt> loadedRows(-1, -1);
 
-                if (!m_searching.load(std::memory_order_relaxed))
-                {
-                    break;
-                }
+        for (const auto row : rows)
+        {
+            if (!m_prefetching.load() || (request != m_prefetchRequest.load()) ||
+                (loadedBytes >= maxBytes))
+            {
+                break;
             }
 
-            if (timer.hasExpired(1000))
+            if ((row >= loadedRows.first) && (row <= loadedRows.second))
             {
-                searchingProgressChanged((row * 100) / m_rowCount.load());
-                if (!rowsPtr->empty())
-                {
-                    emit valueFound(rowsPtr);
-                    rowsPtr = std::make_shared<tp::SIntList>();
-                    searchTime += timer.restart();
-                }
+                continue;
             }
-        }
-
-        searchingProgressChanged(100);
 
-        if (!rowsPtr->empty())
-        {
-            emit valueFound(rowsPtr);
-        }
+            if (const auto entry = m_chunkCache.peek(row); entry)
+            {
+                loadedRows = std::make_pair(entry->getFistRow(), entry->getLastRow());
+                continue;
+            }
 
-        if (row > startingRow)
-        {
-            LOG_INF("Searching finished after {} seconds", searchTime / 1000);
-        }
+            // The rows are put in the cache under the lock, as the cache is cleared under it when the file changes.
+            const std::lock_guard<std::mutex> lock(m_ifsMutex);
+            auto chunkRows = std::make_shared<ChunkRows>();
+            if ((row < 0) || (row >= m_rowCount.load()) || !loadBlockRowsByRow(row, *chunkRows))
+            {
+                continue;
+            }
 
-        if (m_searching.load())
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            loadedRows = std::make_pair(chunkRows->getFistRow(), chunkRows->getLastRow());
+            loadedBytes += chunkRows->memorySize();
+            m_chunkCache.put(std::move(chunkRows));
         }
     }
 }
@@ -198,6 +832,34 @@ tp::SInt BaseLogModel::getRowNum(tp::SInt row) const
     return row;
 }
 
+tp::SInt BaseLogModel::findRowByTime(const std::string &time) const
+{
+    std::optional<std::int64_t> parsedTime;
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        if (m_timeIndex.hasColumn())
+        {
+            parsedTime = m_timeIndex.getParser().parse(time);
+        }
+    }
+
+    if (!parsedTime.has_value())
+    {
+        LOG_WAR("Cannot find the row of the time '{}'", time);
+        return -1;
+    }
+
+    const tp::SInt rowCount(m_rowCount.load());
+    if (rowCount == 0)
+    {
+        return -1;
+    }
+
+    // A time after all the rows goes to the last one.
+    const auto row = findFirstRowAt(parsedTime.value());
+    return row.has_value() ? static_cast<tp::SInt>(row.value()) : (rowCount - 1);
+}
+
 tp::SInt BaseLogModel::getNoMatchColumn() const
 {
     return m_conf->getNoMatchColumn();
@@ -214,31 +876,52 @@ void BaseLogModel::start()
     tryConfigure();
     m_watching.store(true);
     m_watchThread = std::thread(&BaseLogModel::keepWatching, this);
+    m_prefetching.store(true);
+    m_prefetchThread = std::thread(&BaseLogModel::prefetch, this);
 }
 
 void BaseLogModel::stop()
 {
     m_watching.store(false);
+    m_fileWatcher->wakeUp();
     if (m_watchThread.joinable())
     {
         m_watchThread.join();
     }
+    {
+        const std::lock_guard<std::mutex> lock(m_prefetchMutex);
+        m_prefetching.store(false);
+    }
+    m_prefetchCv.notify_one();
+    if (m_prefetchThread.joinable())
+    {
+        m_prefetchThread.join();
+    }
     stopSearch();
+    stopFind();
+    stopCount();
+    saveIndex();
 }
 
 void BaseLogModel::reconfigure()
 {
     stop();
+    m_searchCache.clear();
     m_configured.store(false);
     start();
 }
 
 void BaseLogModel::clear()
 {
+    ++m_generation;
     m_rowCount.store(0);
     m_lastParsedPos = 0;
-    m_cachedChunkRows = ChunkRows();
+    m_savedIndexPos = 0;
+    m_chunkCache.clear();
+    m_tailReader = TailReader::make(m_fileName);
+    m_map.reset();
     m_chunks.clear();
+    m_timeIndex.clear();
 }
 
 bool BaseLogModel::isFollowing() const
@@ -249,6 +932,11 @@ bool BaseLogModel::isFollowing() const
 void BaseLogModel::setFollowing(bool following)
 {
     m_following.store(following);
+    if (following)
+    {
+        // Catches up with the data appended while not following.
+        m_fileWatcher->wakeUp();
+    }
 }
 
 void BaseLogModel::keepWatching()
@@ -283,7 +971,7 @@ void BaseLogModel::keepWatching()
                     break;
                 }
                 newIfs->close();
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                m_fileWatcher->wait();
             } while (m_watching.load(std::memory_order_relaxed));
 
             if (m_watching.load())
@@ -291,6 +979,7 @@ void BaseLogModel::keepWatching()
                 const std::lock_guard<std::mutex> lock(m_ifsMutex);
                 m_ifs->close();
                 m_ifs = std::move(newIfs);
+                m_compressed.store(m_ifs->isCompressed());
                 clear();
             }
         }
@@ -305,6 +994,9 @@ WatchingResult BaseLogModel::watchFile()
         return WatchingResult::FileClosed;
     }
 
+    LOG_INF("Watching '{}' {}", m_fileName, m_fileWatcher->isEventDriven() ? "by events" : "by polling");
+
+    bool replaced(false);
     while (m_watching.load())
     {
         bool mustLoadChunks(false);
@@ -323,14 +1015,19 @@ WatchingResult BaseLogModel::watchFile()
             m_ifs->getStream().seekg(0, std::ios::end);
             auto fileSize = m_ifs->getStream().tellg();
 
-            if (m_lastParsedPos != fileSize)
+            // A rotated file is renamed and another one takes the name, so the opened one stops growing.
+            if (replaced || (fileSize < m_lastParsedPos))
             {
-                if (fileSize < m_lastParsedPos)
-                {
-                    LOG_WAR("File '{}' was recreated", m_fileName);
-                    return WatchingResult::FileRecreated;
-                }
+                LOG_WAR("File '{}' was recreated", m_fileName);
+                // The cached rows and the mapping refer to the old content, so they are dropped before the
+                // file is reopened.
+                m_chunkCache.clear();
+                m_map.reset();
+                return WatchingResult::FileRecreated;
+            }
 
+            if (m_lastParsedPos != fileSize)
+            {
                 m_ifs->getStream().seekg(m_lastParsedPos, std::ios::beg);
                 m_ifs->getStream().peek();
                 if (m_ifs->getStream().fail())
@@ -354,16 +1051,200 @@ WatchingResult BaseLogModel::watchFile()
         {
             loadChunks();
         }
+        // The chunks are sampled again when the time column changes.
+        updateTimeIndex();
 
         if (m_watching.load())
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            replaced = m_fileWatcher->wait();
         }
     }
 
     return WatchingResult::NormalExit;
 }
 
+void BaseLogModel::updateTimeIndex()
+{
+    // The chunks are only added by this thread, so they are read without the lock after taking their ranges.
+    std::vector<Chunk> chunks;
+    TimeParser parser;
+    tp::UInt column(0);
+    InFileStream::Ptr ifs;
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        m_timeIndex.setColumn(getTimeColumn());
+        if (!m_timeIndex.hasColumn() || (m_timeIndex.getChunkCount() >= m_chunks.size()))
+        {
+            return;
+        }
+
+        parser = m_timeIndex.getParser();
+        column = m_timeIndex.getColumn();
+        chunks.assign(m_chunks.begin() + m_timeIndex.getChunkCount(), m_chunks.end());
+        ifs = m_ifs->reopen();
+    }
+
+    // Only the first rows of each block are split and parsed. The blocks are read in order, so a compressed
+    // file is not decompressed again from its checkpoints for each block.
+    std::vector<std::vector<TimeIndex::Sample>> chunkSamples;
+    chunkSamples.reserve(chunks.size());
+    MappedFile::Ptr map;
+    tp::RowData rowData;
+    bool failed(false);
+    for (const auto &chunk : chunks)
+    {
+        if (failed || !m_watching.load())
+        {
+            break;
+        }
+
+        std::vector<TimeIndex::Sample> samples;
+        for (tp::UInt row = chunk.getFistRow(); row <= chunk.getLastRow();)
+        {
+            const Chunk block(chunk.getBlock(row));
+            row = block.getLastRow() + 1;
+
+            const tp::UInt lastRow(std::min(block.getLastRow(), block.getFistRow() + g_timeSampleRows - 1));
+            ChunkRows chunkRows(Chunk(block.getStartPos(), block.getEndPos(), block.getFistRow(), lastRow));
+            if (!readChunkData(chunkRows, *ifs, map))
+            {
+                LOG_ERR("Cannot read the times of the chunk at pos {}", chunk.getStartPos());
+                failed = true;
+                break;
+            }
+
+            loadChunkRows(chunkRows);
+            for (const auto &[blockRow, rawText] : chunkRows.data())
+            {
+                rowData.clear();
+                if (!parseRow(rawText, rowData) || (column >= rowData.size()))
+                {
+                    continue;
+                }
+                if (const auto time = parser.parse(rowData[column]); time.has_value())
+                {
+                    samples.push_back({blockRow, time.value()});
+                    break;
+                }
+            }
+        }
+
+        if (!failed)
+        {
+            chunkSamples.push_back(std::move(samples));
+        }
+    }
+
+    // The chunks are added in order, so the ones not sampled are sampled on the next update.
+    const std::lock_guard<std::mutex> lock(m_ifsMutex);
+    for (tp::UInt i = 0; i < chunkSamples.size(); ++i)
+    {
+        m_timeIndex.addChunk(chunks[i].getLastRow() + 1, chunkSamples[i]);
+    }
+}
+
+std::optional<std::int64_t> BaseLogModel::getRowTime(tp::UInt row, const TimeParser &parser, tp::UInt column) const
+{
+    tp::RowData rowData;
+    if ((getRow(row, rowData) < 0) || (column >= rowData.size()))
+    {
+        return std::nullopt;
+    }
+    return parser.parse(rowData[column]);
+}
+
+std::optional<tp::UInt> BaseLogModel::findFirstRowAt(std::int64_t time) const
+{
+    TimeParser parser;
+    tp::UInt column(0);
+    TimeIndex::RowsAt rows;
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        if (!m_timeIndex.hasColumn())
+        {
+            return std::nullopt;
+        }
+
+        parser = m_timeIndex.getParser();
+        column = m_timeIndex.getColumn();
+        rows = m_timeIndex.findRows(time);
+    }
+
+    // The ranges are the blocks before the sample found in each run, which are loaded by getRow.
+    for (const auto &[firstRow, endRow] : rows.ranges)
+    {
+        for (tp::UInt row = firstRow; row < endRow; ++row)
+        {
+            const auto rowTime = getRowTime(row, parser, column);
+            if (rowTime.has_value() && (rowTime.value() >= time))
+            {
+                return row;
+            }
+        }
+    }
+    return rows.row;
+}
+
+std::optional<std::vector<std::pair<tp::UInt, tp::UInt>>> BaseLogModel::findSearchTimeRows(
+    tp::UInt &checkedRows) const
+{
+    // A row may match any other param of an OR search.
+    if (m_searchOrOp && (m_searchParams.size() > 1))
+    {
+        return std::nullopt;
+    }
+
+    // Only the samples are looked up, so the lock is held all along.
+    const std::lock_guard<std::mutex> lock(m_ifsMutex);
+    if (!m_timeIndex.hasColumn() || !m_timeIndex.getTimeRange().has_value())
+    {
+        return std::nullopt;
+    }
+    checkedRows = m_timeIndex.getRowCount();
+
+    std::optional<std::vector<std::pair<tp::UInt, tp::UInt>>> rows;
+    for (const auto &param : m_searchParams)
+    {
+        if ((param.type != tp::SearchType::Range) || param.flags.has(tp::SearchFlag::NotOperator) ||
+            !param.column.has_value() || (static_cast<tp::UInt>(param.column->idx) != m_timeIndex.getColumn()))
+        {
+            continue;
+        }
+
+        const auto [from, to] = RangeMatcher::splitBounds(param.pattern);
+        const auto fromTime = m_timeIndex.getParser().parse(from);
+        const auto toTime = m_timeIndex.getParser().parse(to);
+        if (!fromTime.has_value() && !toTime.has_value())
+        {
+            continue;
+        }
+
+        auto paramRows = m_timeIndex.findRangeRows(fromTime, toTime);
+        if (!rows.has_value())
+        {
+            rows = std::move(paramRows);
+            continue;
+        }
+
+        // The rows must be in the ranges of every param.
+        std::vector<std::pair<tp::UInt, tp::UInt>> common;
+        auto it = paramRows.begin();
+        for (const auto &range : rows.value())
+        {
+            while ((it != paramRows.end()) && (it->second <= range.first))
+            {
+                ++it;
+            }
+            for (auto next = it; (next != paramRows.end()) && (next->first < range.second); ++next)
+            {
+                common.emplace_back(std::max(range.first, next->first), std::min(range.second, next->second));
+            }
+        }
+        rows = std::move(common);
+    }
+    return rows;
+}
+
 tp::SInt BaseLogModel::getFileSize(std::istream &is)
 {
     tp::SInt fileSize(0);
@@ -424,15 +1305,14 @@ tp::SInt BaseLogModel::readFile(std::istream &is, std::string &buffer, tp::UInt
     return is.gcount();
 }
 
-void BaseLogModel::loadChunks()
+bool BaseLogModel::isCompressed() const
 {
-    LOG_INF("Starting to parse chunks for '{}'", m_fileName);
-    QElapsedTimer timer;
-    timer.start();
+    return m_compressed.load();
+}
 
-    tp::SInt fileSize(0);
+void BaseLogModel::loadChunks()
+{
     tp::UInt nextRow(0);
-    tp::UInt chunkCount(0);
 
     {
         const std::lock_guard<std::mutex> lock(m_ifsMutex);
@@ -441,69 +1321,269 @@ void BaseLogModel::loadChunks()
             LOG_ERR("The ifstream is not good");
             return;
         }
-        fileSize = getFileSize(m_ifs->getStream());
-        chunkCount = m_chunks.size();
+        if (m_chunks.empty())
+        {
+            restoreIndex();
+        }
         if (!m_chunks.empty())
         {
             nextRow = m_chunks.back().getLastRow() + 1;
         }
     }
 
+    // The data appended to a parsed file is usually small, so it's taken from the tail reader, which neither
+    // reopens the file nor queries its size. Bigger amounts of data are parsed in batches from the file.
+    if ((m_lastParsedPos > 0) && m_tailReader->read(m_lastParsedPos, g_chunkSize))
+    {
+        std::vector<Chunk> chunks;
+        const tp::UInt endPos(m_tailReader->getEndPos());
+        const tp::UInt newLastParsedPos(
+            parseChunks(m_tailReader->getStream(), chunks, m_lastParsedPos, nextRow, endPos));
+        addChunks(chunks, newLastParsedPos, endPos);
+        return;
+    }
+
+    LOG_INF("Starting to parse chunks for '{}'", m_fileName);
+    QElapsedTimer timer;
+    timer.start();
+
+    tp::SInt fileSize(0);
+    tp::UInt chunkCount(0);
+    InFileStream::Ptr ifs;
+
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        fileSize = getFileSize(m_ifs->getStream());
+        chunkCount = m_chunks.size();
+        // A compressed file is not decompressed again from its beginning, as the checkpoints are shared.
+        ifs = m_ifs->reopen();
+    }
+
     std::vector<Chunk> chunks;
-    tp::SInt newLastParsedPos(0);
+    tp::SInt newLastParsedPos(m_lastParsedPos);
 
-    do
+    while (m_watching.load(std::memory_order_relaxed) && (newLastParsedPos < fileSize))
     {
-        auto ifs(InFileStream::make(m_fileName));
         moveFilePos(ifs->getStream(), m_lastParsedPos);
         newLastParsedPos = parseChunks(ifs->getStream(), chunks, m_lastParsedPos, nextRow, fileSize);
-        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        nextRow = addChunks(chunks, newLastParsedPos, fileSize);
+    }
 
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
         m_ifs = std::move(ifs);
+    }
+
+    parsingProgressChanged(100);
+
+    // Indexing a big file may take a while, so it's persisted right away instead of waiting for stop().
+    if (timer.elapsed() >= 1000)
+    {
+        saveIndex();
+    }
+
+    chunkCount = m_chunks.size() - chunkCount;
+    logIndexMemory();
+    LOG_INF("{} chunks parsed in {} ms", chunkCount, timer.elapsed());
+}
+
+tp::UInt BaseLogModel::addChunks(std::vector<Chunk> &chunks, tp::UInt newLastParsedPos, tp::UInt fileSize)
+{
+    tp::UInt rowCount(0);
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+
         if (!chunks.empty())
         {
             m_chunks.reserve(m_chunks.size() + chunks.size());
             std::move(std::begin(chunks), std::end(chunks), std::back_inserter(m_chunks));
             chunks.clear();
         }
+
+        rowCount = m_chunks.empty() ? 0 : (m_chunks.back().getLastRow() + 1);
         if (newLastParsedPos > m_lastParsedPos)
         {
             m_lastParsedPos = newLastParsedPos;
 
-            tp::UInt rowCount(m_chunks.empty() ? 0 : (m_chunks.back().getLastRow() + 1));
             if (rowCount != m_rowCount.load())
             {
-                nextRow = rowCount;
-                m_rowCount.store(rowCount);
+                const tp::UInt prevRowCount(m_rowCount.exchange(rowCount));
+                publishIndexedRows(prevRowCount, rowCount);
                 emit countChanged();
                 parsingProgressChanged((newLastParsedPos * 100) / fileSize);
             }
         }
+    }
 
-    } while (m_watching.load(std::memory_order_relaxed) && (newLastParsedPos < fileSize));
+    // The times of the new chunks are sampled while their blocks are still cached by the system.
+    updateTimeIndex();
+    return rowCount;
+}
 
-    parsingProgressChanged(100);
+void BaseLogModel::publishIndexedRows(tp::UInt fromRow, tp::UInt toRow)
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_indexedMutex);
+        // Nobody consumes them while not searching.
+        if (!m_searching.load())
+        {
+            return;
+        }
+        m_indexedRows.emplace_back(fromRow, toRow);
+    }
+    m_indexedCv.notify_one();
+}
 
-    chunkCount = m_chunks.size() - chunkCount;
-    LOG_INF("{} chunks parsed in {} seconds", chunkCount, timer.elapsed() / 1000);
+void BaseLogModel::logIndexMemory() const
+{
+    tp::UInt checkpoints(0);
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        for (const auto &chunk : m_chunks)
+        {
+            checkpoints += chunk.getCheckpoints().size();
+        }
+    }
+
+    const tp::UInt indexBytes((m_chunks.size() * sizeof(Chunk)) + (checkpoints * sizeof(RowCheckpoint)));
+    const double indexedGB(std::max<tp::UInt>(m_lastParsedPos, 1) / (1024.0 * 1024.0 * 1024.0));
+    LOG_INF(
+        "Index of '{}' has {} chunks and {} row checkpoints, using {} KB ({:.0f} KB per GB)",
+        m_fileName,
+        m_chunks.size(),
+        checkpoints,
+        indexBytes / 1024,
+        (indexBytes / 1024.0) / indexedGB);
+}
+
+void BaseLogModel::restoreIndex()
+{
+    // The decompression checkpoints are not persisted, so the index of a compressed file is useless alone.
+    if (isCompressed())
+    {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<Chunk> chunks;
+    m_timeIndex.setColumn(getTimeColumn());
+    const auto parsedPos = m_indexCache.load(chunks, m_timeIndex);
+    if (!parsedPos.has_value())
+    {
+        return;
+    }
+
+    m_chunks = std::move(chunks);
+    m_lastParsedPos = parsedPos.value();
+    m_savedIndexPos = m_lastParsedPos;
+    m_rowCount.store(m_chunks.back().getLastRow() + 1);
+    publishIndexedRows(0, m_rowCount.load());
+    emit countChanged();
+
+    LOG_INF(
+        "Index of '{}' restored from cache with {} chunks up to pos {} in {} ms",
+        m_fileName,
+        m_chunks.size(),
+        m_lastParsedPos,
+        timer.elapsed());
+}
+
+void BaseLogModel::saveIndex()
+{
+    // Small files are parsed quickly, so they aren't worth caching.
+    if ((m_lastParsedPos == m_savedIndexPos) || (m_lastParsedPos < g_chunkSize) || isCompressed())
+    {
+        return;
+    }
+
+    std::vector<Chunk> chunks;
+    TimeIndex timeIndex;
+    tp::UInt parsedPos(0);
+    {
+        const std::lock_guard<std::mutex> lock(m_ifsMutex);
+        chunks = m_chunks;
+        timeIndex = m_timeIndex;
+        parsedPos = m_lastParsedPos;
+    }
+
+    // The saved position is the last complete line, so the trailing row is parsed again on the next load.
+    if (const auto savedPos = m_indexCache.save(std::move(chunks), parsedPos, timeIndex); savedPos)
+    {
+        m_savedIndexPos = parsedPos;
+        LOG_INF("Index of '{}' saved up to pos {}", m_fileName, savedPos.value());
+    }
 }
 
-bool BaseLogModel::loadChunkRowsByRow(tp::UInt row, ChunkRows &chunkRows) const
+bool BaseLogModel::loadBlockRowsByRow(tp::UInt row, ChunkRows &chunkRows) const
 {
+    // Only the few KB between the checkpoints around the row are loaded, instead of the whole chunk.
     const auto chunk = std::lower_bound(m_chunks.begin(), m_chunks.end(), row, Chunk::compareRows);
     if ((chunk != m_chunks.end()) && chunk->countainRow(row))
     {
-        ChunkRows tmpChunkRows(*chunk);
-        loadChunkRows(m_ifs->getStream(), tmpChunkRows);
-        if (tmpChunkRows.rowCount() != chunk->getRowCount())
+        return loadRows(chunk->getBlock(row), chunkRows);
+    }
+    return false;
+}
+
+bool BaseLogModel::loadRows(const Chunk &range, ChunkRows &chunkRows) const
+{
+    ChunkRows tmpChunkRows(range);
+    if (!loadChunkData(tmpChunkRows))
+    {
+        LOG_ERR("Cannot load the data of the chunk at pos {}", range.getStartPos());
+        return false;
+    }
+    loadChunkRows(tmpChunkRows);
+    if (tmpChunkRows.rowCount() != range.getRowCount())
+    {
+        LOG_ERR(
+            "The cached chunk rows {} does not match the chunk info {}",
+            tmpChunkRows.rowCount(),
+            range.getRowCount());
+    }
+    chunkRows = std::move(tmpChunkRows);
+    return true;
+}
+
+bool BaseLogModel::loadChunkData(ChunkRows &chunkRows) const
+{
+    return readChunkData(chunkRows, *m_ifs, m_map);
+}
+
+bool BaseLogModel::readChunkData(ChunkRows &chunkRows, InFileStream &ifs, MappedFile::Ptr &map) const
+{
+    const tp::UInt startPos(chunkRows.getStartPos());
+    const tp::UInt endPos(chunkRows.getEndPos());
+    const tp::UInt dataSize(endPos - startPos);
+
+    if (!ifs.isCompressed())
+    {
+        // The mapping is a snapshot of the file, so it's remapped only when a range beyond it is required.
+        if (!map || !map->contains(startPos, dataSize))
+        {
+            map = MappedFile::make(m_fileName);
+        }
+
+        // Accessing a mapped page that is no longer backed by the file raises SIGBUS, so it's checked
+        // whether the file was truncated since the mapping.
+        if (map->contains(startPos, dataSize) && (map->fileSize() >= static_cast<tp::SInt>(endPos)))
         {
-            LOG_ERR(
-                "The cached chunk rows {} does not match the chunk info {}",
-                tmpChunkRows.rowCount(),
-                chunk->getRowCount());
+            chunkRows.setData(map);
+            return true;
         }
-        chunkRows = std::move(tmpChunkRows);
-        return true;
     }
-    return false;
+
+    // Fallback for when the file cannot be mapped. A compressed file is decompressed from the checkpoint
+    // before the position.
+    std::string buffer;
+    buffer.resize(dataSize);
+    if (!moveFilePos(ifs.getStream(), startPos))
+    {
+        return false;
+    }
+    buffer.resize(readFile(ifs.getStream(), buffer, dataSize));
+    chunkRows.setData(std::move(buffer));
+    return true;
 }
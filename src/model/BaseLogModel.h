@@ -4,12 +4,23 @@
 #pragma once
 
 #include "AbstractModel.h"
+#include "ChunkCache.h"
+#include "FileWatcher.h"
 #include "InFileStream.h"
+#include "IndexCache.h"
+#include "MappedFile.h"
 #include "Matcher.h"
+#include "SearchCache.h"
+#include "TimeIndex.h"
+#include "Histogram.h"
+#include "TailReader.h"
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 
 constexpr tp::UInt g_chunkSize = (1024 * 1024) * 10;
+// Approximate distance in bytes between the row checkpoints of a chunk.
+constexpr tp::UInt g_checkpointSpacing = 1024 * 16;
 
 enum class WatchingResult
 {
@@ -20,6 +31,13 @@ enum class WatchingResult
     UnknownFailure
 };
 
+// Start of a row inside a chunk, relative to the chunk's first row and start position.
+struct RowCheckpoint
+{
+    std::uint32_t rowOffset;
+    std::uint32_t posOffset;
+};
+
 class Chunk
 {
 public:
@@ -39,21 +57,103 @@ public:
     bool countainRow(const tp::UInt &row) const { return ((row >= getFistRow()) && (row <= getLastRow())); }
     static bool compareRows(const Chunk &c, const tp::UInt &row) { return (c.getLastRow() < row); }
 
+    // Records that the row starts at pos. It must be called in ascending order,
+    // and the checkpoints outside the chunk or too close to the previous one are ignored.
+    void addCheckpoint(tp::UInt row, tp::UInt pos)
+    {
+        if ((row <= getFistRow()) || (row > getLastRow()) || (pos <= getStartPos()) || (pos >= getEndPos()) ||
+            ((pos - getStartPos()) > std::numeric_limits<std::uint32_t>::max()))
+        {
+            return;
+        }
+
+        const RowCheckpoint cp{
+            static_cast<std::uint32_t>(row - getFistRow()),
+            static_cast<std::uint32_t>(pos - getStartPos())};
+        if (m_checkpoints.empty() ||
+            ((cp.rowOffset > m_checkpoints.back().rowOffset) &&
+             (cp.posOffset >= m_checkpoints.back().posOffset + g_checkpointSpacing)))
+        {
+            m_checkpoints.push_back(cp);
+        }
+    }
+    void addCheckpoint(const RowCheckpoint &cp)
+    {
+        addCheckpoint(getFistRow() + cp.rowOffset, getStartPos() + cp.posOffset);
+    }
+    const std::vector<RowCheckpoint> &getCheckpoints() const { return m_checkpoints; }
+    void shrinkCheckpoints() { m_checkpoints.shrink_to_fit(); }
+
+    // Returns the range of rows between the checkpoints around the row, without checkpoints.
+    Chunk getBlock(tp::UInt row) const
+    {
+        const std::uint32_t rowOffset(row - getFistRow());
+        const auto it = std::upper_bound(
+            m_checkpoints.begin(),
+            m_checkpoints.end(),
+            rowOffset,
+            [](std::uint32_t offset, const RowCheckpoint &cp) { return (offset < cp.rowOffset); });
+
+        tp::UInt startPos(getStartPos());
+        tp::UInt firstRow(getFistRow());
+        if (it != m_checkpoints.begin())
+        {
+            startPos += std::prev(it)->posOffset;
+            firstRow += std::prev(it)->rowOffset;
+        }
+
+        if (it != m_checkpoints.end())
+        {
+            return Chunk(startPos, getStartPos() + it->posOffset, firstRow, getFistRow() + it->rowOffset - 1);
+        }
+        return Chunk(startPos, getEndPos(), firstRow, getLastRow());
+    }
+
+    // Gives the range from the block containing the row up to the end of the chunk.
+    Chunk getTail(tp::UInt row) const
+    {
+        const Chunk block(getBlock(row));
+        return Chunk(block.getStartPos(), getEndPos(), block.getFistRow(), getLastRow());
+    }
+
 private:
     std::pair<tp::UInt, tp::UInt> m_posRange;
     std::pair<tp::UInt, tp::UInt> m_rowRange;
+    std::vector<RowCheckpoint> m_checkpoints;
 };
 
+// Rows of a range of the file, which is either a whole chunk or a block of it.
 class ChunkRows
 {
 public:
-    using ChunkRowsData = std::pair<tp::UInt, std::string>;
+    using ChunkRowsData = std::pair<tp::UInt, std::string_view>;
 
-    ChunkRows(const Chunk &chunk) : m_chunk(&chunk) {}
+    ChunkRows(const Chunk &chunk)
+        : m_posRange(std::make_pair(chunk.getStartPos(), chunk.getEndPos())),
+          m_rowRange(std::make_pair(chunk.getFistRow(), chunk.getLastRow()))
+    {
+    }
     ChunkRows() = default;
-    void add(tp::UInt row, const std::string &content) { m_rows.emplace_back(row, content); }
+    tp::UInt getStartPos() const { return m_posRange.first; }
+    tp::UInt getEndPos() const { return m_posRange.second; }
+    tp::UInt getFistRow() const { return m_rowRange.first; }
+    tp::UInt getLastRow() const { return m_rowRange.second; }
+    // The rows are views into the range data, which is either the mapped file or a buffer read from the file.
+    // The chunk rows hold the mapping, so the views remain valid until the cache drops them.
+    void setData(const MappedFile::Ptr &map)
+    {
+        m_map = map;
+        m_data = map->view(getStartPos(), getEndPos() - getStartPos());
+    }
+    void setData(std::string &&buffer)
+    {
+        m_buffer = std::make_shared<const std::string>(std::move(buffer));
+        m_data = *m_buffer;
+    }
+    std::string_view getData() const { return m_data; }
+    void add(tp::UInt row, std::string_view content) { m_rows.emplace_back(row, content); }
     void reserve(tp::UInt size) { m_rows.reserve(size); }
-    const std::string &get(tp::UInt row) const
+    std::string_view get(tp::UInt row) const
     {
         const auto it = std::lower_bound(m_rows.begin(), m_rows.end(), row, compareRows);
         if ((it != m_rows.end()) && (row == it->first))
@@ -66,13 +166,17 @@ public:
         return (it != m_rows.end() && row == it->first);
     }
     tp::UInt rowCount() const { return m_rows.size(); }
-    const Chunk *getChunk() { return m_chunk; }
     const std::vector<ChunkRowsData> &data() { return m_rows; }
+    tp::UInt memorySize() const { return m_data.size() + (m_rows.capacity() * sizeof(ChunkRowsData)); }
 
     static bool compareRows(const ChunkRowsData &rowData, const tp::UInt &row) { return (rowData.first < row); }
 
 private:
-    const Chunk *m_chunk = nullptr;
+    std::pair<tp::UInt, tp::UInt> m_posRange;
+    std::pair<tp::UInt, tp::UInt> m_rowRange;
+    MappedFile::Ptr m_map;
+    std::shared_ptr<const std::string> m_buffer;
+    std::string_view m_data;
     std::vector<ChunkRowsData> m_rows;
 };
 
@@ -91,10 +195,19 @@ public:
     tp::UInt columnCount() const override final;
     tp::UInt rowCount() const override final;
     tp::SInt getRowNum(tp::SInt row) const override final;
+    void prefetchRows(const std::vector<tp::SInt> &rows) override final;
+    tp::SInt findRowByTime(const std::string &time) const override final;
     tp::SInt getNoMatchColumn() const;
     void startSearch(const tp::SearchParams &params, bool orOp);
     void stopSearch();
     bool isSearching() const;
+    // Finds in background the nearest row after the given one matching the params, or before it when backward,
+    // which is emitted by rowFound, or -1 when there is none.
+    void startFind(const tp::SearchParams &params, bool orOp, tp::SInt fromRow, bool backward);
+    void stopFind();
+    // Counts in background the rows matching the params, by time or by row, which are emitted by histogramFound.
+    void startCount(const tp::SearchParams &params, bool orOp);
+    void stopCount();
     bool isWatching() const;
     void start();
     void stop();
@@ -104,21 +217,25 @@ public:
 signals:
     void parsingProgressChanged(int progress);
     void searchingProgressChanged(int progress);
+    void countingProgressChanged(int progress);
     void valueFound(tp::SharedSIntList rowsPtr) const;
+    void rowFound(tp::SInt row) const;
+    void histogramFound(Histogram::Ptr histogram) const;
 
 public slots:
     void setFollowing(bool following);
 
 protected:
     virtual bool configure(FileConf::Ptr conf, std::istream &is) = 0;
-    virtual bool parseRow(const std::string &rawText, tp::RowData &rowData) const = 0;
+    virtual bool parseRow(std::string_view rawText, tp::RowData &rowData) const = 0;
     virtual tp::UInt parseChunks(
         std::istream &is,
         std::vector<Chunk> &chunks,
         tp::UInt fromPos,
         tp::UInt nextRow,
         tp::UInt fileSize) = 0;
-    virtual void loadChunkRows(std::istream &is, ChunkRows &chunkRows) const = 0;
+    // Splits the data of the range into rows.
+    virtual void loadChunkRows(ChunkRows &chunkRows) const = 0;
 
     // Helping funtions to operate over istream.
     static tp::SInt getFileSize(std::istream &is);
@@ -126,31 +243,94 @@ protected:
     static bool isEndOfFile(std::istream &is);
     static bool moveFilePos(std::istream &is, tp::UInt pos);
     static tp::SInt readFile(std::istream &is, std::string &buffer, tp::UInt bytes);
+    // The positions of a compressed file refer to its uncompressed data, so it cannot be mapped.
+    bool isCompressed() const;
 
 private:
     void clear();
     void loadChunks();
-    bool loadChunkRowsByRow(tp::UInt row, ChunkRows &chunkRows) const;
+    tp::UInt addChunks(std::vector<Chunk> &chunks, tp::UInt newLastParsedPos, tp::UInt fileSize);
+    // Notifies the search of the rows [fromRow, toRow), which were just indexed.
+    void publishIndexedRows(tp::UInt fromRow, tp::UInt toRow);
+    void restoreIndex();
+    void logIndexMemory() const;
+    void saveIndex();
+    bool loadBlockRowsByRow(tp::UInt row, ChunkRows &chunkRows) const;
+    bool loadRows(const Chunk &range, ChunkRows &chunkRows) const;
+    bool loadChunkData(ChunkRows &chunkRows) const;
+    // Same as loadChunkData, but through the given file, so it can run without the lock.
+    bool readChunkData(ChunkRows &chunkRows, InFileStream &ifs, MappedFile::Ptr &map) const;
     void keepWatching();
     WatchingResult watchFile();
+    // Adds to the time index the samples of the chunks indexed since the last call.
+    void updateTimeIndex();
+    std::optional<std::int64_t> getRowTime(tp::UInt row, const TimeParser &parser, tp::UInt column) const;
+    // Returns the first row at or after the time, by binary search inside the runs of ordered samples.
+    std::optional<tp::UInt> findFirstRowAt(std::int64_t time) const;
+    // Ranges of rows [first, end) that can match the time range params of the search. Only the first
+    // checkedRows rows are sampled, so the rows after them can match as well.
+    std::optional<std::vector<std::pair<tp::UInt, tp::UInt>>> findSearchTimeRows(tp::UInt &checkedRows) const;
     void search();
+    // Searches the chunks in parallel and emits the rows found, which are added to foundRows, returning the row
+    // after the last searched one. The rows searched by the candidates are matched only when found by them.
+    // The mappings of the workers are kept in maps, so the next call can reuse them.
+    tp::UInt searchChunks(
+        const std::vector<Chunk> &chunks,
+        tp::UInt fromRow,
+        tp::UInt rowCount,
+        const SearchCache::Entry *candidates,
+        RowSet &foundRows,
+        std::vector<MappedFile::Ptr> &maps);
+    void find(const tp::SearchParams &params, bool orOp, tp::SInt fromRow, bool backward);
+    void count(const tp::SearchParams &params, bool orOp);
+    void prefetch();
     void tryConfigure();
     FileConf::Ptr m_conf;
     std::string m_fileName;
+    IndexCache m_indexCache;
     mutable InFileStream::Ptr m_ifs;
+    FileWatcher::Ptr m_fileWatcher;
+    // Accessed only by m_watchThread.
+    TailReader::Ptr m_tailReader;
+    mutable MappedFile::Ptr m_map;
     mutable std::mutex m_ifsMutex;
-    mutable ChunkRows m_cachedChunkRows;
+    mutable ChunkCache m_chunkCache;
     std::vector<Chunk> m_chunks;
-    Matcher m_matcher;
+    // Updated by m_watchThread and guarded by m_ifsMutex as well.
+    TimeIndex m_timeIndex;
+    // Set before starting m_searchThread. Each search worker makes its own matchers from them.
+    tp::SearchParams m_searchParams;
+    bool m_searchOrOp = false;
     std::thread m_searchThread;
+    // Accessed only by m_searchThread, or while it's stopped.
+    SearchCache m_searchCache;
+    // Row ranges published by m_watchThread as they are indexed, and consumed by m_searchThread.
+    std::mutex m_indexedMutex;
+    std::condition_variable m_indexedCv;
+    std::deque<std::pair<tp::UInt, tp::UInt>> m_indexedRows;
+    std::thread m_findThread;
+    std::thread m_countThread;
     std::thread m_watchThread;
+    std::thread m_prefetchThread;
+    std::mutex m_prefetchMutex;
+    std::condition_variable m_prefetchCv;
+    // Rows requested by the last call to prefetchRows, which replace the previous ones.
+    std::vector<tp::SInt> m_prefetchRows;
+    std::atomic_size_t m_prefetchRequest = 0;
     // Control flags that are set in the main thread and read by other threads.
     std::atomic_bool m_searching = false;
+    std::atomic_bool m_finding = false;
+    std::atomic_bool m_counting = false;
     std::atomic_bool m_watching = false;
+    std::atomic_bool m_prefetching = false;
     std::atomic_bool m_following = true;
     std::atomic_bool m_configured = false;
     // Set by m_watchThread and read by main and m_searchThread threads.
     std::atomic_size_t m_rowCount = 0;
-    // Accessed only by m_watchThread.
+    std::atomic_bool m_compressed = false;
+    // Incremented by m_watchThread when the file is reloaded, so the cached search results are discarded.
+    std::atomic_size_t m_generation = 0;
+    // Accessed only by m_watchThread, or after joining it.
     tp::UInt m_lastParsedPos = 0;
+    tp::UInt m_savedIndexPos = 0;
 };
@@ -0,0 +1,77 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "ChunkCache.h"
+#include "BaseLogModel.h"
+
+ChunkCache::ChunkCache(tp::UInt maxBytes) : m_maxBytes(maxBytes)
+{
+}
+
+ChunkCache::Entry ChunkCache::get(tp::UInt row)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_index.lower_bound(row);
+    if ((it != m_index.end()) && ((*it->second)->getFistRow() <= row))
+    {
+        // Moves the entry to the front, keeping the iterators valid.
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return m_entries.front();
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+ChunkCache::Entry ChunkCache::peek(tp::UInt row)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_index.lower_bound(row);
+    if ((it != m_index.end()) && ((*it->second)->getFistRow() <= row))
+    {
+        return *it->second;
+    }
+    return nullptr;
+}
+
+void ChunkCache::put(Entry entry)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
+    const tp::UInt lastRow(entry->getLastRow());
+    if (const auto it = m_index.find(lastRow); it != m_index.end())
+    {
+        m_bytes -= (*it->second)->memorySize();
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+
+    m_bytes += entry->memorySize();
+    m_entries.push_front(std::move(entry));
+    m_index.emplace(lastRow, m_entries.begin());
+    evict();
+}
+
+void ChunkCache::clear()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_bytes = 0;
+}
+
+void ChunkCache::evict()
+{
+    // The most recent entry is always kept, even if it alone exceeds the limit.
+    while ((m_bytes > m_maxBytes) && (m_entries.size() > 1))
+    {
+        const auto &entry = m_entries.back();
+        m_bytes -= entry->memorySize();
+        m_index.erase(entry->getLastRow());
+        m_entries.pop_back();
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include <list>
+#include <mutex>
+
+class ChunkRows;
+
+// LRU cache of loaded rows, bounded by the memory used by them.
+// The entries are shared, so they remain valid for the threads using them after being evicted.
+class ChunkCache
+{
+public:
+    using Entry = std::shared_ptr<const ChunkRows>;
+
+    ChunkCache(tp::UInt maxBytes);
+
+    // Returns the entry containing the row, or nullptr if it's not cached.
+    Entry get(tp::UInt row);
+    // Same as get(), but without changing the LRU order and the counters.
+    Entry peek(tp::UInt row);
+    void put(Entry entry);
+    void clear();
+    tp::UInt getMaxBytes() const { return m_maxBytes; }
+    tp::UInt getHits() const { return m_hits.load(std::memory_order_relaxed); }
+    tp::UInt getMisses() const { return m_misses.load(std::memory_order_relaxed); }
+
+private:
+    using EntryList = std::list<Entry>;
+
+    void evict();
+
+    std::mutex m_mutex;
+    // Most recently used first.
+    EntryList m_entries;
+    // Entries by their last row, as they don't overlap.
+    std::map<tp::UInt, EntryList::iterator> m_index;
+    tp::UInt m_bytes = 0;
+    tp::UInt m_maxBytes;
+    std::atomic<tp::UInt> m_hits = 0;
+    std::atomic<tp::UInt> m_misses = 0;
+};
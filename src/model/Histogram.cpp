@@ -0,0 +1,87 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "Histogram.h"
+#include <array>
+
+void Histogram::add(Counts &counts, std::int64_t idx, tp::UInt row)
+{
+    auto &bucket = counts[idx];
+    ++bucket.count;
+    bucket.firstRow = std::min(bucket.firstRow, row);
+}
+
+void Histogram::merge(Counts &counts, const Counts &other)
+{
+    for (const auto &[idx, bucket] : other)
+    {
+        auto &merged = counts[idx];
+        merged.count += bucket.count;
+        merged.firstRow = std::min(merged.firstRow, bucket.firstRow);
+    }
+}
+
+std::int64_t Histogram::getBucket(std::int64_t value, std::int64_t bucketSize)
+{
+    const std::int64_t idx(value / bucketSize);
+    return (((value % bucketSize) != 0) && (value < 0)) ? (idx - 1) : idx;
+}
+
+std::int64_t Histogram::getTimeBucketSize(std::int64_t timeSpan)
+{
+    constexpr std::int64_t second(1000000000);
+    constexpr std::int64_t minute(60 * second);
+    constexpr std::int64_t hour(60 * minute);
+    constexpr std::int64_t day(24 * hour);
+    static const std::array<std::int64_t, 16> sizes{
+        second,
+        5 * second,
+        10 * second,
+        30 * second,
+        minute,
+        5 * minute,
+        10 * minute,
+        30 * minute,
+        hour,
+        3 * hour,
+        6 * hour,
+        12 * hour,
+        day,
+        7 * day,
+        30 * day,
+        365 * day};
+
+    const auto it = std::find_if(
+        sizes.begin(),
+        sizes.end(),
+        [timeSpan](std::int64_t size) { return ((timeSpan / size) < static_cast<std::int64_t>(s_maxBuckets)); });
+    return (it != sizes.end()) ? *it : sizes.back();
+}
+
+void Histogram::setCounts(const Counts &counts)
+{
+    buckets.clear();
+    count = untimedCount;
+    if (counts.empty())
+    {
+        return;
+    }
+
+    const std::int64_t firstIdx(counts.begin()->first);
+    const std::int64_t lastIdx(counts.rbegin()->first);
+    const std::int64_t joined(((lastIdx - firstIdx) / static_cast<std::int64_t>(s_maxBuckets)) + 1);
+    const std::int64_t firstBucket(getBucket(firstIdx, joined));
+
+    buckets.resize(getBucket(lastIdx, joined) - firstBucket + 1);
+    for (const auto &[idx, bucket] : counts)
+    {
+        auto &joinedBucket = buckets[getBucket(idx, joined) - firstBucket];
+        joinedBucket.count += bucket.count;
+        joinedBucket.firstRow = std::min(joinedBucket.firstRow, bucket.firstRow);
+        count += bucket.count;
+    }
+
+    bucketSize *= joined;
+    start = firstBucket * bucketSize;
+}
@@ -0,0 +1,42 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include <map>
+
+// Number of rows matching a search, counted in buckets of time of the time column, or else of rows.
+struct Histogram
+{
+    using Ptr = std::shared_ptr<const Histogram>;
+
+    struct Bucket
+    {
+        tp::UInt count = 0;
+        // The first row counted in the bucket, which is the one it's navigated to.
+        tp::UInt firstRow = std::numeric_limits<tp::UInt>::max();
+    };
+    // Buckets by their index, which are counted apart by each search worker and merged at the end.
+    using Counts = std::map<std::int64_t, Bucket>;
+
+    static void add(Counts &counts, std::int64_t idx, tp::UInt row);
+    static void merge(Counts &counts, const Counts &other);
+    // Index of the bucket of the value, which may be negative, as the times before the epoch.
+    static std::int64_t getBucket(std::int64_t value, std::int64_t bucketSize);
+    // The shortest round interval splitting the time span in at most s_maxBuckets.
+    static std::int64_t getTimeBucketSize(std::int64_t timeSpan);
+
+    // Sets the buckets from the first to the last counted, joining the adjacent ones when they are too many.
+    void setCounts(const Counts &counts);
+
+    static constexpr tp::UInt s_maxBuckets = 240;
+
+    bool byTime = false;
+    // Start of the first bucket and size of each one, in nanoseconds since the epoch or in rows.
+    std::int64_t start = 0;
+    std::int64_t bucketSize = 1;
+    std::vector<Bucket> buckets;
+    // The rows matched without a time, when the buckets are of time.
+    tp::UInt untimedCount = 0;
+    tp::UInt count = 0;
+};
@@ -0,0 +1,417 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "IndexCache.h"
+#include "BaseLogModel.h"
+#include "InFileStream.h"
+#include "Settings.h"
+#include <cstring>
+#include <sys/stat.h>
+
+namespace
+{
+
+constexpr char g_magic[8] = {'Q', 'L', 'E', 'I', 'D', 'X', '\0', '\0'};
+constexpr std::uint32_t g_version(3);
+constexpr tp::UInt g_hashBlockSize(64 * 1024);
+constexpr int g_maxCacheFiles(100);
+constexpr qint64 g_maxCacheAgeDays(30);
+constexpr tp::UInt g_maxFormatSize(1024);
+
+struct FileId
+{
+    std::uint64_t dev = 0;
+    std::uint64_t ino = 0;
+    std::int64_t size = -1;
+    std::int64_t mtime = 0;
+};
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t fileType;
+    std::uint64_t chunkSize;
+    FileId fileId;
+    std::uint64_t parsedPos;
+    std::uint64_t headHash;
+    std::uint64_t tailHash;
+    std::uint64_t chunkCount;
+};
+
+struct ChunkEntry
+{
+    std::uint64_t startPos;
+    std::uint64_t endPos;
+    std::uint64_t firstRow;
+    std::uint64_t lastRow;
+    std::uint64_t checkpointCount;
+};
+
+// Written after the chunks, followed by the format and then by the sample count and the samples of each chunk.
+struct TimeEntry
+{
+    std::uint64_t column;
+    std::uint64_t formatSize;
+    std::uint64_t chunkCount;
+};
+
+// FNV-1a, which is stable across builds and platforms, unlike std::hash.
+std::uint64_t fnv1a(const char *data, tp::UInt size, std::uint64_t hash = 0xcbf29ce484222325ULL)
+{
+    for (tp::UInt i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+FileId getFileId(const std::string &fileName)
+{
+    FileId id;
+#if defined(_WIN32)
+    // There is no inode on Windows, so the file is identified only by its size, mtime and content hashes.
+    const QFileInfo info(QString::fromStdString(fileName));
+    if (info.exists())
+    {
+        id.size = info.size();
+        id.mtime = info.lastModified().toMSecsSinceEpoch();
+    }
+#else
+    struct stat st;
+    if (::stat(fileName.c_str(), &st) == 0)
+    {
+        id.dev = st.st_dev;
+        id.ino = st.st_ino;
+        id.size = st.st_size;
+#if defined(__APPLE__)
+        id.mtime = (static_cast<std::int64_t>(st.st_mtimespec.tv_sec) * 1000000000) + st.st_mtimespec.tv_nsec;
+#else
+        id.mtime = (static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000) + st.st_mtim.tv_nsec;
+#endif
+    }
+#endif
+    return id;
+}
+
+// Hashes the first and the last blocks of the range [0, endPos) of the file.
+bool hashBlocks(const std::string &fileName, tp::UInt endPos, std::uint64_t &headHash, std::uint64_t &tailHash)
+{
+    auto ifs = InFileStream::make(fileName);
+    if (!ifs->isOpen())
+    {
+        return false;
+    }
+
+    auto &is = ifs->getStream();
+    std::string buffer(std::min(endPos, g_hashBlockSize), '\0');
+
+    is.seekg(0, std::ios::beg);
+    is.read(buffer.data(), buffer.size());
+    if (static_cast<tp::UInt>(is.gcount()) != buffer.size())
+    {
+        return false;
+    }
+    headHash = fnv1a(buffer.data(), buffer.size());
+
+    is.seekg(endPos - buffer.size(), std::ios::beg);
+    is.read(buffer.data(), buffer.size());
+    if (static_cast<tp::UInt>(is.gcount()) != buffer.size())
+    {
+        return false;
+    }
+    tailHash = fnv1a(buffer.data(), buffer.size());
+
+    return true;
+}
+
+bool endsWithLineBreak(const std::string &fileName, tp::UInt pos)
+{
+    auto ifs = InFileStream::make(fileName);
+    if (!ifs->isOpen() || (pos == 0))
+    {
+        return false;
+    }
+
+    auto &is = ifs->getStream();
+    is.seekg(pos - 1, std::ios::beg);
+    return (is.get() == '\n');
+}
+
+// Removes the caches not used for a long time, and the least recently used ones above the limit.
+void removeOldCaches(const QDir &cacheDir)
+{
+    const auto files = cacheDir.entryInfoList(QStringList() << "*.idx", QDir::Files, QDir::Time);
+    const QDateTime minTime(QDateTime::currentDateTime().addDays(-g_maxCacheAgeDays));
+    for (int i = 0; i < files.size(); ++i)
+    {
+        if ((i >= g_maxCacheFiles) || (files[i].lastModified() < minTime))
+        {
+            LOG_INF("Removing the index cache '{}'", utl::toStr(files[i].absoluteFilePath()));
+            QFile::remove(files[i].absoluteFilePath());
+        }
+    }
+}
+
+template <typename T> bool readVal(std::istream &is, T &val)
+{
+    is.read(reinterpret_cast<char *>(&val), sizeof(T));
+    return is.good();
+}
+
+template <typename T> void writeVal(std::ostream &os, const T &val)
+{
+    os.write(reinterpret_cast<const char *>(&val), sizeof(T));
+}
+
+} // namespace
+
+IndexCache::IndexCache(const std::string &fileName, tp::FileType fileType)
+    : m_fileName(fileName),
+      m_fileType(fileType)
+{
+    const QString absPath(QFileInfo(QString::fromStdString(fileName)).absoluteFilePath());
+    const std::string pathStr(utl::toStr(absPath));
+    const QDir cacheDir(Settings::getSettingsDir("index-cache"));
+    m_cacheFileName = utl::toStr(cacheDir.absoluteFilePath(
+        QString::fromStdString(fmt::format("{:016x}.idx", fnv1a(pathStr.data(), pathStr.size())))));
+}
+
+std::optional<tp::UInt> IndexCache::load(std::vector<Chunk> &chunks, TimeIndex &timeIndex) const
+{
+    std::ifstream ifs(m_cacheFileName, std::ios::binary);
+    if (!ifs.is_open())
+    {
+        return std::nullopt;
+    }
+
+    Header header{};
+    if (!readVal(ifs, header) || (std::memcmp(header.magic, g_magic, sizeof(g_magic)) != 0) ||
+        (header.version != g_version) || (header.fileType != static_cast<std::uint32_t>(m_fileType)) ||
+        (header.chunkSize != g_chunkSize) || (header.chunkCount == 0))
+    {
+        LOG_INF("Ignoring incompatible index cache '{}'", m_cacheFileName);
+        return std::nullopt;
+    }
+
+    const FileId fileId = getFileId(m_fileName);
+    if ((fileId.dev != header.fileId.dev) || (fileId.ino != header.fileId.ino) ||
+        (fileId.size < static_cast<std::int64_t>(header.parsedPos)))
+    {
+        return std::nullopt;
+    }
+
+    // A file with the same size must also be untouched. A bigger one is checked by the hashes below,
+    // since appending to it changes the mtime.
+    if ((fileId.size == header.fileId.size) && (fileId.mtime != header.fileId.mtime))
+    {
+        return std::nullopt;
+    }
+
+    std::uint64_t headHash(0);
+    std::uint64_t tailHash(0);
+    if (!hashBlocks(m_fileName, header.parsedPos, headHash, tailHash) || (headHash != header.headHash) ||
+        (tailHash != header.tailHash))
+    {
+        LOG_INF("The index cache of '{}' is outdated", m_fileName);
+        return std::nullopt;
+    }
+
+    std::vector<Chunk> cachedChunks;
+    cachedChunks.reserve(header.chunkCount);
+    tp::UInt nextPos(0);
+    tp::UInt nextRow(0);
+    for (std::uint64_t i = 0; i < header.chunkCount; ++i)
+    {
+        ChunkEntry entry{};
+        if (!readVal(ifs, entry) || (entry.startPos != nextPos) || (entry.firstRow != nextRow) ||
+            (entry.endPos <= entry.startPos) || (entry.lastRow < entry.firstRow))
+        {
+            LOG_ERR("The index cache '{}' is corrupted", m_cacheFileName);
+            return std::nullopt;
+        }
+        auto &chunk = cachedChunks.emplace_back(entry.startPos, entry.endPos, entry.firstRow, entry.lastRow);
+        for (std::uint64_t j = 0; j < entry.checkpointCount; ++j)
+        {
+            RowCheckpoint cp{};
+            if (!readVal(ifs, cp))
+            {
+                LOG_ERR("The index cache '{}' is corrupted", m_cacheFileName);
+                return std::nullopt;
+            }
+            chunk.addCheckpoint(cp);
+        }
+        chunk.shrinkCheckpoints();
+        nextPos = entry.endPos;
+        nextRow = entry.lastRow + 1;
+    }
+
+    if (nextPos != header.parsedPos)
+    {
+        LOG_ERR("The index cache '{}' is corrupted", m_cacheFileName);
+        return std::nullopt;
+    }
+
+    TimeEntry timeEntry{};
+    std::string format;
+    if (!readVal(ifs, timeEntry) || (timeEntry.chunkCount > cachedChunks.size()) ||
+        (timeEntry.formatSize > g_maxFormatSize))
+    {
+        LOG_ERR("The index cache '{}' is corrupted", m_cacheFileName);
+        return std::nullopt;
+    }
+    format.resize(timeEntry.formatSize);
+    if (!ifs.read(format.data(), format.size()))
+    {
+        LOG_ERR("The index cache '{}' is corrupted", m_cacheFileName);
+        return std::nullopt;
+    }
+
+    // The times are sampled again when the time column changed since they were saved.
+    std::vector<std::vector<TimeIndex::Sample>> chunkSamples;
+    if (timeIndex.hasColumn() && (timeIndex.getChunkCount() == 0) && (timeEntry.column == timeIndex.getColumn()) &&
+        (format == timeIndex.getParser().getFormat()))
+    {
+        chunkSamples.resize(timeEntry.chunkCount);
+        for (auto &samples : chunkSamples)
+        {
+            std::uint64_t sampleCount(0);
+            if (!readVal(ifs, sampleCount))
+            {
+                LOG_ERR("The index cache '{}' is corrupted", m_cacheFileName);
+                return std::nullopt;
+            }
+            samples.resize(sampleCount);
+            for (auto &sample : samples)
+            {
+                if (!readVal(ifs, sample))
+                {
+                    LOG_ERR("The index cache '{}' is corrupted", m_cacheFileName);
+                    return std::nullopt;
+                }
+            }
+        }
+    }
+
+    // The modification time tells when the cache was last used, so the unused ones can be removed.
+    QFile cacheFile(QString::fromStdString(m_cacheFileName));
+    if (cacheFile.open(QIODevice::Append))
+    {
+        cacheFile.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    for (tp::UInt i = 0; i < chunkSamples.size(); ++i)
+    {
+        timeIndex.addChunk(cachedChunks[i].getLastRow() + 1, chunkSamples[i]);
+    }
+    chunks = std::move(cachedChunks);
+    return header.parsedPos;
+}
+
+std::optional<tp::UInt> IndexCache::save(
+    std::vector<Chunk> chunks,
+    tp::UInt parsedPos,
+    const TimeIndex &timeIndex) const
+{
+    if (chunks.empty() || (chunks.back().getEndPos() != parsedPos))
+    {
+        return std::nullopt;
+    }
+
+    // A chunk may end with a row that has no line break yet, which would be saved incomplete.
+    while (!chunks.empty() && !endsWithLineBreak(m_fileName, chunks.back().getEndPos()))
+    {
+        chunks.pop_back();
+    }
+    if (chunks.empty())
+    {
+        return std::nullopt;
+    }
+    parsedPos = chunks.back().getEndPos();
+
+    const QDir cacheDir(Settings::getSettingsDir("index-cache"));
+    if (!cacheDir.exists() && !cacheDir.mkpath(cacheDir.absolutePath()))
+    {
+        LOG_ERR("Cannot create the index cache directory {}", utl::toStr(cacheDir.absolutePath()));
+        return std::nullopt;
+    }
+
+    Header header{};
+    std::memcpy(header.magic, g_magic, sizeof(g_magic));
+    header.version = g_version;
+    header.fileType = static_cast<std::uint32_t>(m_fileType);
+    header.chunkSize = g_chunkSize;
+    header.fileId = getFileId(m_fileName);
+    header.parsedPos = parsedPos;
+    header.chunkCount = chunks.size();
+    if ((header.fileId.size < static_cast<std::int64_t>(parsedPos)) ||
+        !hashBlocks(m_fileName, parsedPos, header.headHash, header.tailHash))
+    {
+        return std::nullopt;
+    }
+
+    // Written to a temporary file first, so a crash never leaves a truncated cache behind.
+    const std::string tmpFileName(m_cacheFileName + ".tmp");
+    {
+        std::ofstream ofs(tmpFileName, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open())
+        {
+            LOG_ERR("Unable to open {}", tmpFileName);
+            return std::nullopt;
+        }
+
+        writeVal(ofs, header);
+        for (const auto &chunk : chunks)
+        {
+            const auto &checkpoints = chunk.getCheckpoints();
+            const ChunkEntry entry{
+                chunk.getStartPos(),
+                chunk.getEndPos(),
+                chunk.getFistRow(),
+                chunk.getLastRow(),
+                checkpoints.size()};
+            writeVal(ofs, entry);
+            for (const auto &cp : checkpoints)
+            {
+                writeVal(ofs, cp);
+            }
+        }
+
+        const std::string format(timeIndex.hasColumn() ? timeIndex.getParser().getFormat() : std::string());
+        const TimeEntry timeEntry{
+            timeIndex.hasColumn() ? timeIndex.getColumn() : 0,
+            format.size(),
+            std::min<tp::UInt>(timeIndex.getChunkCount(), chunks.size())};
+        writeVal(ofs, timeEntry);
+        ofs.write(format.data(), format.size());
+        for (tp::UInt i = 0; i < timeEntry.chunkCount; ++i)
+        {
+            const auto samples = timeIndex.getChunkSamples(i);
+            writeVal(ofs, static_cast<std::uint64_t>(samples.size()));
+            for (const auto &sample : samples)
+            {
+                writeVal(ofs, sample);
+            }
+        }
+
+        ofs.flush();
+        if (!ofs.good())
+        {
+            LOG_ERR("Cannot write the index cache {}", tmpFileName);
+            return std::nullopt;
+        }
+    }
+
+    QFile::remove(m_cacheFileName.c_str());
+    if (!QFile::rename(tmpFileName.c_str(), m_cacheFileName.c_str()))
+    {
+        LOG_ERR("Cannot rename {} to {}", tmpFileName, m_cacheFileName);
+        QFile::remove(tmpFileName.c_str());
+        return std::nullopt;
+    }
+
+    removeOldCaches(cacheDir);
+    return parsedPos;
+}
@@ -0,0 +1,29 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+class Chunk;
+class TimeIndex;
+
+// Persists the chunk index of a log file, including the row checkpoints and the sampled times, in the settings
+// directory, so reopening a file only requires parsing the bytes appended since the index was saved.
+// The cache is keyed by the file path and validated against the file identity (device, inode, size, mtime)
+// and the hashes of the first and last indexed blocks. Only the least recently used caches are kept.
+class IndexCache
+{
+public:
+    IndexCache(const std::string &fileName, tp::FileType fileType);
+
+    // Returns the position where the parsing must continue, or nullopt if there is no valid cache for the file.
+    // The sampled times are added to the empty time index only when they were taken from its column.
+    std::optional<tp::UInt> load(std::vector<Chunk> &chunks, TimeIndex &timeIndex) const;
+    // Saves the chunks up to the last complete line, as a trailing row without line break may still grow.
+    // Returns the position saved, or nullopt if nothing was saved.
+    std::optional<tp::UInt> save(std::vector<Chunk> chunks, tp::UInt parsedPos, const TimeIndex &timeIndex) const;
+
+private:
+    std::string m_fileName;
+    tp::FileType m_fileType;
+    std::string m_cacheFileName;
+};
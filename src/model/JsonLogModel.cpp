@@ -6,14 +6,6 @@
 
 constexpr tp::UInt g_maxChunksPerParse(50);
 
-std::string toString(const rapidjson::Value &json)
-{
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    json.Accept(writer);
-    return buffer.GetString();
-}
-
 JsonLogModel::JsonLogModel(FileConf::Ptr conf, QObject *parent) : BaseLogModel(conf, parent)
 {
 }
@@ -68,10 +60,10 @@ bool JsonLogModel::configure(FileConf::Ptr conf, std::istream &is)
     return !conf->getColumns().empty();
 }
 
-bool JsonLogModel::parseRow(const std::string &rawText, tp::RowData &rowData) const
+bool JsonLogModel::parseRow(std::string_view rawText, tp::RowData &rowData) const
 {
     rapidjson::Document d;
-    d.Parse<rapidjson::kParseStopWhenDoneFlag>(rawText.c_str());
+    d.Parse<rapidjson::kParseStopWhenDoneFlag>(rawText.data(), rawText.size());
     for (const auto &col : getColumns())
     {
         std::string colText;
@@ -114,9 +106,6 @@ tp::UInt JsonLogModel::parseChunks(
     tp::UInt nextRow,
     tp::UInt fileSize)
 {
-    std::string buffer;
-    buffer.resize(g_chunkSize);
-
     const tp::UInt totalChunks(std::max<tp::UInt>((fileSize - fromPos) / g_chunkSize, 1));
     chunks.reserve(totalChunks);
 
@@ -129,6 +118,8 @@ tp::UInt JsonLogModel::parseChunks(
 
     tp::UInt chunkStartPos = getFilePos(is);
     tp::UInt last_pos = chunkStartPos;
+    tp::UInt lastCheckpointPos = chunkStartPos;
+    std::vector<std::pair<tp::UInt, tp::UInt>> checkpoints;
 
     while (!isEndOfFile(is) && (chunks.size() < g_maxChunksPerParse))
     {
@@ -139,6 +130,11 @@ tp::UInt JsonLogModel::parseChunks(
             ++currentRowCount;
             last_pos = getFilePos(is);
             mustAddRowsToChunk = (g_chunkSize < (last_pos - chunkStartPos));
+            if ((last_pos - lastCheckpointPos) >= g_checkpointSpacing)
+            {
+                checkpoints.emplace_back(currentRowCount, last_pos);
+                lastCheckpointPos = last_pos;
+            }
         }
         else if (currentRowCount > nextFirstChunkRow)
         {
@@ -153,6 +149,12 @@ tp::UInt JsonLogModel::parseChunks(
         if (mustAddRowsToChunk)
         {
             chunks.emplace_back(chunkStartPos, last_pos, nextFirstChunkRow, currentRowCount - 1);
+            for (const auto &[row, pos] : checkpoints)
+            {
+                chunks.back().addCheckpoint(row, pos);
+            }
+            chunks.back().shrinkCheckpoints();
+            checkpoints.clear();
             nextFirstChunkRow = currentRowCount;
             chunkStartPos = last_pos;
         }
@@ -168,25 +170,38 @@ tp::UInt JsonLogModel::parseChunks(
     }
 }
 
-void JsonLogModel::loadChunkRows(std::istream &is, ChunkRows &chunkRows) const
+void JsonLogModel::loadChunkRows(ChunkRows &chunkRows) const
 {
-    moveFilePos(is, chunkRows.getChunk()->getStartPos());
-
-    const auto lastRow = chunkRows.getChunk()->getLastRow();
-    auto curentRow = chunkRows.getChunk()->getFistRow();
+    const auto lastRow = chunkRows.getLastRow();
+    auto curentRow = chunkRows.getFistRow();
 
     chunkRows.reserve(lastRow - curentRow + 1);
 
-    rapidjson::IStreamWrapper isw(is);
+    const std::string_view data(chunkRows.getData());
+    rapidjson::Reader reader;
+    rapidjson::BaseReaderHandler handler;
+    rapidjson::MemoryStream ms(data.data(), data.size());
 
     while (curentRow <= lastRow)
     {
-        rapidjson::Document d;
-        d.ParseStream<rapidjson::kParseStopWhenDoneFlag>(isw);
-        if (!d.HasParseError())
+        // Skip the separators, so the row starts at the beginning of the json object.
+        while ((ms.Tell() < data.size()) && std::isspace(static_cast<unsigned char>(ms.Peek())))
         {
-            chunkRows.add(curentRow, toString(d));
-            ++curentRow;
+            ms.Take();
         }
+
+        const auto rowStart = ms.Tell();
+        const auto res = reader.Parse<rapidjson::kParseStopWhenDoneFlag>(ms, handler);
+        if (res.IsError())
+        {
+            LOG_ERR(
+                "Error parsing json row {} at pos {}",
+                curentRow,
+                chunkRows.getStartPos() + res.Offset());
+            break;
+        }
+
+        chunkRows.add(curentRow, data.substr(rowStart, ms.Tell() - rowStart));
+        ++curentRow;
     }
 }
@@ -15,12 +15,12 @@ public:
 
 protected:
     bool configure(FileConf::Ptr conf, std::istream &is) override;
-    bool parseRow(const std::string &rawText, tp::RowData &rowData) const override;
+    bool parseRow(std::string_view rawText, tp::RowData &rowData) const override;
     virtual tp::UInt parseChunks(
         std::istream &is,
         std::vector<Chunk> &chunks,
         tp::UInt fromPos,
         tp::UInt nextRow,
         tp::UInt fileSize) override;
-    virtual void loadChunkRows(std::istream &is, ChunkRows &chunkRows) const override;
+    virtual void loadChunkRows(ChunkRows &chunkRows) const override;
 };
@@ -11,9 +11,9 @@ ProxyModel::ProxyModel(AbstractModel *source) : AbstractModel(source), m_source(
 
 tp::SInt ProxyModel::getRow(tp::SInt row, tp::RowData &rowData) const
 {
-    if (row < m_rowMap.size())
+    if ((-1L < row) && (row < m_rowMap.size()))
     {
-        return m_source->getRow(m_rowMap[row], rowData);
+        return m_source->getRow(m_rowMap.select(row), rowData);
     }
     return -1;
 }
@@ -47,30 +47,51 @@ tp::SInt ProxyModel::getRowNum(tp::SInt row) const
 {
     if ((-1L < row) && (row < m_rowMap.size()))
     {
-        return m_source->getRowNum(m_rowMap[row]);
+        return m_source->getRowNum(m_rowMap.select(row));
     }
 
     return -1;
 }
 
+void ProxyModel::prefetchRows(const std::vector<tp::SInt> &rows)
+{
+    std::vector<tp::SInt> srcRows;
+    srcRows.reserve(rows.size());
+    for (const auto row : rows)
+    {
+        if ((-1L < row) && (row < m_rowMap.size()))
+        {
+            srcRows.push_back(m_rowMap.select(row));
+        }
+    }
+    m_source->prefetchRows(srcRows);
+}
+
+tp::SInt ProxyModel::findRowByTime(const std::string &time) const
+{
+    // The first row of the proxy at or after the source row, or the last one.
+    const tp::SInt srcRow(m_source->findRowByTime(time));
+    if ((srcRow < 0) || m_rowMap.empty())
+    {
+        return -1;
+    }
+    return std::min<tp::SInt>(m_rowMap.rank(srcRow), m_rowMap.size() - 1);
+}
+
 tp::SInt ProxyModel::findSourceRow(tp::SInt srcRow) const
 {
-    auto it = std::lower_bound(m_rowMap.begin(), m_rowMap.end(), srcRow);
-    return (it != m_rowMap.end() && srcRow == *it) ? std::distance(m_rowMap.begin(), it) : -1L;
+    return constainsSourceRow(srcRow) ? m_rowMap.rank(srcRow) : -1L;
 }
 
 bool ProxyModel::constainsSourceRow(tp::SInt srcRow) const
 {
-    const auto it = std::lower_bound(m_rowMap.begin(), m_rowMap.end(), srcRow);
-    return (it != m_rowMap.end() && srcRow == *it);
+    return (-1L < srcRow) && m_rowMap.contains(srcRow);
 }
 
 void ProxyModel::addSourceRow(tp::SInt srcRow)
 {
-    if (!constainsSourceRow(srcRow))
+    if ((-1L < srcRow) && m_rowMap.add(srcRow))
     {
-        m_rowMap.push_back(srcRow);
-        PARALLEL_SORT(m_rowMap.begin(), m_rowMap.end());
         emit countChanged();
     }
 }
@@ -81,13 +102,23 @@ void ProxyModel::addSourceRows(const tp::SIntList &srcRows)
 
     for (const auto srcRow : srcRows)
     {
-        if (!constainsSourceRow(srcRow))
+        if (-1L < srcRow)
         {
-            m_rowMap.push_back(srcRow);
+            m_rowMap.add(srcRow);
         }
     }
 
-    PARALLEL_SORT(m_rowMap.begin(), m_rowMap.end());
+    if (m_rowMap.size() != oldSize)
+    {
+        emit countChanged();
+    }
+}
+
+void ProxyModel::addSourceRows(const RowSet &srcRows)
+{
+    const tp::UInt oldSize(m_rowMap.size());
+
+    m_rowMap |= srcRows;
 
     if (m_rowMap.size() != oldSize)
     {
@@ -97,10 +128,8 @@ void ProxyModel::addSourceRows(const tp::SIntList &srcRows)
 
 void ProxyModel::removeSourceRow(tp::SInt srcRow)
 {
-    const auto pos = findSourceRow(srcRow);
-    if (pos != -1)
+    if ((-1L < srcRow) && m_rowMap.remove(srcRow))
     {
-        m_rowMap.erase(m_rowMap.begin() + pos);
         emit countChanged();
     }
 }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "AbstractModel.h"
+#include "RowSet.h"
 
 class ProxyModel : public AbstractModel
 {
@@ -18,11 +19,14 @@ public:
     tp::UInt columnCount() const override;
     tp::UInt rowCount() const override;
     tp::SInt getRowNum(tp::SInt row) const override;
+    void prefetchRows(const std::vector<tp::SInt> &rows) override;
+    tp::SInt findRowByTime(const std::string &time) const override;
 
     tp::SInt findSourceRow(tp::SInt srcRow) const;
     bool constainsSourceRow(tp::SInt srcRow) const;
     void addSourceRow(tp::SInt srcRow);
     void addSourceRows(const tp::SIntList &srcRows);
+    void addSourceRows(const RowSet &srcRows);
     void removeSourceRow(tp::SInt srcRow);
     void clear();
 
@@ -31,5 +35,6 @@ signals:
 
 private:
     AbstractModel *m_source;
-    tp::SIntList m_rowMap;
+    // Rows of the source, which are mapped to the rows of the proxy by their rank.
+    RowSet m_rowMap;
 };
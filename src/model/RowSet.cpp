@@ -0,0 +1,441 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "RowSet.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+
+constexpr tp::UInt g_blockBits(16);
+constexpr tp::UInt g_bitmapWords((1 << g_blockBits) / 64);
+// Above this size, a bitmap is smaller than the array.
+constexpr tp::UInt g_maxArraySize(4096);
+
+tp::UInt popCount(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+    return __popcnt64(word);
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+tp::UInt countTrailingZeros(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, word);
+    return idx;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+std::uint16_t getLow(tp::UInt row)
+{
+    return static_cast<std::uint16_t>(row & ((1 << g_blockBits) - 1));
+}
+
+} // namespace
+
+bool RowSet::Block::contains(std::uint16_t low) const
+{
+    if (isBitmap())
+    {
+        return (m_bitmap[low / 64] >> (low % 64)) & 1;
+    }
+    return std::binary_search(m_array.begin(), m_array.end(), low);
+}
+
+bool RowSet::Block::add(std::uint16_t low)
+{
+    if (isBitmap())
+    {
+        auto &word = m_bitmap[low / 64];
+        const std::uint64_t bit(std::uint64_t(1) << (low % 64));
+        if (word & bit)
+        {
+            return false;
+        }
+        word |= bit;
+    }
+    else
+    {
+        // The rows are usually added in order, which only appends them.
+        const bool isLast(m_array.empty() || (m_array.back() < low));
+        const auto it = isLast ? m_array.end() : std::lower_bound(m_array.begin(), m_array.end(), low);
+        if ((it != m_array.end()) && (*it == low))
+        {
+            return false;
+        }
+        m_array.insert(it, low);
+    }
+
+    if ((++m_size > g_maxArraySize) && !isBitmap())
+    {
+        toBitmap();
+    }
+    return true;
+}
+
+bool RowSet::Block::remove(std::uint16_t low)
+{
+    if (isBitmap())
+    {
+        auto &word = m_bitmap[low / 64];
+        const std::uint64_t bit(std::uint64_t(1) << (low % 64));
+        if (!(word & bit))
+        {
+            return false;
+        }
+        word &= ~bit;
+        if (--m_size <= g_maxArraySize)
+        {
+            toArray();
+        }
+    }
+    else
+    {
+        const auto it = std::lower_bound(m_array.begin(), m_array.end(), low);
+        if ((it == m_array.end()) || (*it != low))
+        {
+            return false;
+        }
+        m_array.erase(it);
+        --m_size;
+    }
+    return true;
+}
+
+tp::UInt RowSet::Block::rank(std::uint16_t low) const
+{
+    if (isBitmap())
+    {
+        tp::UInt count(0);
+        for (tp::UInt i = 0; i < low / 64; ++i)
+        {
+            count += popCount(m_bitmap[i]);
+        }
+        return count + popCount(m_bitmap[low / 64] & ((std::uint64_t(1) << (low % 64)) - 1));
+    }
+    return std::lower_bound(m_array.begin(), m_array.end(), low) - m_array.begin();
+}
+
+std::uint16_t RowSet::Block::select(tp::UInt idx) const
+{
+    if (!isBitmap())
+    {
+        return m_array[idx];
+    }
+
+    for (tp::UInt i = 0; i < m_bitmap.size(); ++i)
+    {
+        std::uint64_t word(m_bitmap[i]);
+        const tp::UInt count(popCount(word));
+        if (idx < count)
+        {
+            // Clears the lowest bits until the wanted one is the lowest.
+            for (; idx > 0; --idx)
+            {
+                word &= word - 1;
+            }
+            return static_cast<std::uint16_t>((i * 64) + countTrailingZeros(word));
+        }
+        idx -= count;
+    }
+    return 0;
+}
+
+void RowSet::Block::appendTo(tp::UInt base, tp::SIntList &rows) const
+{
+    if (!isBitmap())
+    {
+        for (const auto low : m_array)
+        {
+            rows.push_back(base | low);
+        }
+        return;
+    }
+
+    for (tp::UInt i = 0; i < m_bitmap.size(); ++i)
+    {
+        for (std::uint64_t word = m_bitmap[i]; word != 0; word &= word - 1)
+        {
+            rows.push_back(base | ((i * 64) + countTrailingZeros(word)));
+        }
+    }
+}
+
+void RowSet::Block::unite(const Block &other)
+{
+    if (!isBitmap() && !other.isBitmap() && ((m_size + other.m_size) <= g_maxArraySize))
+    {
+        std::vector<std::uint16_t> merged;
+        merged.reserve(m_size + other.m_size);
+        std::set_union(
+            m_array.begin(),
+            m_array.end(),
+            other.m_array.begin(),
+            other.m_array.end(),
+            std::back_inserter(merged));
+        m_array = std::move(merged);
+        m_size = m_array.size();
+        return;
+    }
+
+    toBitmap();
+    if (other.isBitmap())
+    {
+        for (tp::UInt i = 0; i < g_bitmapWords; ++i)
+        {
+            m_bitmap[i] |= other.m_bitmap[i];
+        }
+    }
+    else
+    {
+        for (const auto low : other.m_array)
+        {
+            m_bitmap[low / 64] |= std::uint64_t(1) << (low % 64);
+        }
+    }
+
+    m_size = 0;
+    for (const auto word : m_bitmap)
+    {
+        m_size += popCount(word);
+    }
+}
+
+void RowSet::Block::intersect(const Block &other)
+{
+    if (isBitmap() && other.isBitmap())
+    {
+        m_size = 0;
+        for (tp::UInt i = 0; i < g_bitmapWords; ++i)
+        {
+            m_bitmap[i] &= other.m_bitmap[i];
+            m_size += popCount(m_bitmap[i]);
+        }
+        if (m_size <= g_maxArraySize)
+        {
+            toArray();
+        }
+        return;
+    }
+
+    // The result is not bigger than the array, so it's filtered by the other block.
+    const Block &array = isBitmap() ? other : *this;
+    const Block &filter = isBitmap() ? *this : other;
+    std::vector<std::uint16_t> common;
+    common.reserve(array.m_size);
+    std::copy_if(
+        array.m_array.begin(),
+        array.m_array.end(),
+        std::back_inserter(common),
+        [&filter](std::uint16_t low) { return filter.contains(low); });
+
+    m_bitmap.clear();
+    m_bitmap.shrink_to_fit();
+    m_array = std::move(common);
+    m_size = m_array.size();
+}
+
+tp::UInt RowSet::Block::memorySize() const
+{
+    return (m_array.capacity() * sizeof(std::uint16_t)) + (m_bitmap.capacity() * sizeof(std::uint64_t));
+}
+
+void RowSet::Block::toBitmap()
+{
+    if (isBitmap())
+    {
+        return;
+    }
+
+    m_bitmap.assign(g_bitmapWords, 0);
+    for (const auto low : m_array)
+    {
+        m_bitmap[low / 64] |= std::uint64_t(1) << (low % 64);
+    }
+    m_array.clear();
+    m_array.shrink_to_fit();
+}
+
+void RowSet::Block::toArray()
+{
+    if (!isBitmap())
+    {
+        return;
+    }
+
+    m_array.clear();
+    m_array.reserve(m_size);
+    for (tp::UInt i = 0; i < m_bitmap.size(); ++i)
+    {
+        for (std::uint64_t word = m_bitmap[i]; word != 0; word &= word - 1)
+        {
+            m_array.push_back(static_cast<std::uint16_t>((i * 64) + countTrailingZeros(word)));
+        }
+    }
+    m_bitmap.clear();
+    m_bitmap.shrink_to_fit();
+}
+
+bool RowSet::contains(tp::UInt row) const
+{
+    const tp::UInt high(row >> g_blockBits);
+    return (high < m_blocks.size()) && m_blocks[high].contains(getLow(row));
+}
+
+bool RowSet::add(tp::UInt row)
+{
+    const tp::UInt high(row >> g_blockBits);
+    if (high >= m_blocks.size())
+    {
+        m_blocks.resize(high + 1);
+    }
+
+    if (!m_blocks[high].add(getLow(row)))
+    {
+        return false;
+    }
+    ++m_size;
+    m_ranksUpdated = false;
+    return true;
+}
+
+bool RowSet::remove(tp::UInt row)
+{
+    const tp::UInt high(row >> g_blockBits);
+    if ((high >= m_blocks.size()) || !m_blocks[high].remove(getLow(row)))
+    {
+        return false;
+    }
+    --m_size;
+    m_ranksUpdated = false;
+    return true;
+}
+
+void RowSet::clear()
+{
+    m_blocks.clear();
+    m_size = 0;
+    m_ranks.clear();
+    m_ranksUpdated = false;
+}
+
+tp::UInt RowSet::rank(tp::UInt row) const
+{
+    const tp::UInt high(row >> g_blockBits);
+    if (high >= m_blocks.size())
+    {
+        return m_size;
+    }
+
+    updateRanks();
+    return m_ranks[high] + m_blocks[high].rank(getLow(row));
+}
+
+tp::UInt RowSet::select(tp::UInt idx) const
+{
+    updateRanks();
+    // The last block starting at or before the index, which is not empty as the index is in the set.
+    const auto it = std::upper_bound(m_ranks.begin(), m_ranks.end(), idx) - 1;
+    const tp::UInt high(it - m_ranks.begin());
+    return (high << g_blockBits) | m_blocks[high].select(idx - *it);
+}
+
+tp::UInt RowSet::count(tp::UInt fromRow, tp::UInt toRow) const
+{
+    // Counted within the blocks, as the ranks are updated lazily.
+    tp::UInt count(0);
+    for (tp::UInt high = fromRow >> g_blockBits; (high < m_blocks.size()) && (fromRow < toRow); ++high)
+    {
+        const auto &block = m_blocks[high];
+        const tp::UInt blockEnd((high + 1) << g_blockBits);
+        const tp::UInt endRank((toRow < blockEnd) ? block.rank(getLow(toRow)) : block.size());
+        count += endRank - block.rank(getLow(fromRow));
+        fromRow = blockEnd;
+    }
+    return count;
+}
+
+void RowSet::appendTo(tp::SIntList &rows) const
+{
+    for (tp::UInt high = 0; high < m_blocks.size(); ++high)
+    {
+        m_blocks[high].appendTo(high << g_blockBits, rows);
+    }
+}
+
+RowSet &RowSet::operator|=(const RowSet &other)
+{
+    if (other.m_blocks.size() > m_blocks.size())
+    {
+        m_blocks.resize(other.m_blocks.size());
+    }
+
+    m_size = 0;
+    for (tp::UInt i = 0; i < m_blocks.size(); ++i)
+    {
+        if ((i < other.m_blocks.size()) && (other.m_blocks[i].size() > 0))
+        {
+            m_blocks[i].unite(other.m_blocks[i]);
+        }
+        m_size += m_blocks[i].size();
+    }
+    m_ranksUpdated = false;
+    return *this;
+}
+
+RowSet &RowSet::operator&=(const RowSet &other)
+{
+    if (m_blocks.size() > other.m_blocks.size())
+    {
+        m_blocks.resize(other.m_blocks.size());
+    }
+
+    m_size = 0;
+    for (tp::UInt i = 0; i < m_blocks.size(); ++i)
+    {
+        if (m_blocks[i].size() > 0)
+        {
+            m_blocks[i].intersect(other.m_blocks[i]);
+        }
+        m_size += m_blocks[i].size();
+    }
+    m_ranksUpdated = false;
+    return *this;
+}
+
+tp::UInt RowSet::memorySize() const
+{
+    tp::UInt bytes((m_blocks.capacity() * sizeof(Block)) + (m_ranks.capacity() * sizeof(tp::UInt)));
+    for (const auto &block : m_blocks)
+    {
+        bytes += block.memorySize();
+    }
+    return bytes;
+}
+
+void RowSet::updateRanks() const
+{
+    if (m_ranksUpdated)
+    {
+        return;
+    }
+
+    m_ranks.resize(m_blocks.size());
+    tp::UInt count(0);
+    for (tp::UInt i = 0; i < m_blocks.size(); ++i)
+    {
+        m_ranks[i] = count;
+        count += m_blocks[i].size();
+    }
+    m_ranksUpdated = true;
+}
@@ -0,0 +1,70 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+// Compressed set of rows, as a roaring bitmap: the rows are split in blocks of 65536 by their high bits, and each
+// block keeps the low bits in a sorted array while it's sparse, or in a bitmap when it's dense.
+// The blocks are indexed by their high bits, so looking up a row is O(1), and a row is mapped to its index and
+// back through the number of rows before each block.
+class RowSet
+{
+public:
+    bool contains(tp::UInt row) const;
+    // Returns whether the row was added, which is false when it was already in the set.
+    bool add(tp::UInt row);
+    // Returns whether the row was removed, which is false when it was not in the set.
+    bool remove(tp::UInt row);
+    void clear();
+    tp::UInt size() const { return m_size; }
+    bool empty() const { return (m_size == 0); }
+
+    // Number of rows of the set before the row, which is the index of the row when it's in the set.
+    tp::UInt rank(tp::UInt row) const;
+    // The row at the index, which must be smaller than size().
+    tp::UInt select(tp::UInt idx) const;
+    // Number of rows of the set in [fromRow, toRow). Unlike rank, it can be called concurrently.
+    tp::UInt count(tp::UInt fromRow, tp::UInt toRow) const;
+    // Appends the rows in ascending order.
+    void appendTo(tp::SIntList &rows) const;
+
+    // Union and intersection, linear on the size of the blocks.
+    RowSet &operator|=(const RowSet &other);
+    RowSet &operator&=(const RowSet &other);
+
+    tp::UInt memorySize() const;
+
+private:
+    class Block
+    {
+    public:
+        bool contains(std::uint16_t low) const;
+        bool add(std::uint16_t low);
+        bool remove(std::uint16_t low);
+        tp::UInt size() const { return m_size; }
+        tp::UInt rank(std::uint16_t low) const;
+        std::uint16_t select(tp::UInt idx) const;
+        void appendTo(tp::UInt base, tp::SIntList &rows) const;
+        void unite(const Block &other);
+        void intersect(const Block &other);
+        tp::UInt memorySize() const;
+
+    private:
+        void toBitmap();
+        void toArray();
+        bool isBitmap() const { return !m_bitmap.empty(); }
+
+        std::vector<std::uint16_t> m_array;
+        std::vector<std::uint64_t> m_bitmap;
+        tp::UInt m_size = 0;
+    };
+
+    void updateRanks() const;
+
+    // Indexed by the high bits of the rows.
+    std::vector<Block> m_blocks;
+    tp::UInt m_size = 0;
+    // Number of rows before each block, which is updated on the first rank or select after a change.
+    mutable std::vector<tp::UInt> m_ranks;
+    mutable bool m_ranksUpdated = false;
+};
@@ -0,0 +1,120 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "SearchCache.h"
+
+SearchCache::EntryPtr SearchCache::find(const tp::SearchParams &params, bool orOp, tp::UInt generation)
+{
+    // The rows left to match are the ones found by an entry, and the ones it did not search.
+    const auto leftRows = [](const Entry &entry)
+    { return static_cast<tp::SInt>(entry.rows.size()) - static_cast<tp::SInt>(entry.searchedRows); };
+
+    auto found = m_entries.end();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        const auto &entry = **it;
+        if ((entry.generation != generation) || !implies(params, orOp, entry.params, entry.orOp))
+        {
+            continue;
+        }
+
+        if (implies(entry.params, entry.orOp, params, orOp))
+        {
+            found = it;
+            break;
+        }
+
+        if ((found == m_entries.end()) || (leftRows(entry) < leftRows(**found)))
+        {
+            found = it;
+        }
+    }
+
+    if (found == m_entries.end())
+    {
+        return nullptr;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, found);
+    return m_entries.front();
+}
+
+void SearchCache::put(Entry &&entry)
+{
+    m_entries.remove_if(
+        [&entry](const EntryPtr &cached)
+        { return (cached->generation != entry.generation) || isSame(*cached, entry.params, entry.orOp); });
+
+    m_entries.push_front(std::make_shared<const Entry>(std::move(entry)));
+    while (m_entries.size() > s_maxEntries)
+    {
+        m_entries.pop_back();
+    }
+}
+
+void SearchCache::clear()
+{
+    m_entries.clear();
+}
+
+bool SearchCache::implies(const tp::SearchParams &params, bool orOp, const tp::SearchParams &other, bool otherOrOp)
+{
+    // A single param has the same results with both operators.
+    orOp = orOp && (params.size() > 1);
+    otherOrOp = otherOrOp && (other.size() > 1);
+
+    if (!orOp)
+    {
+        // A row matching all the params matches the other params implied by any of them.
+        const auto isImplied = [&params](const tp::SearchParam &otherParam)
+        {
+            return std::any_of(
+                params.begin(),
+                params.end(),
+                [&otherParam](const tp::SearchParam &param) { return implies(param, otherParam); });
+        };
+        return otherOrOp ? std::any_of(other.begin(), other.end(), isImplied)
+                         : std::all_of(other.begin(), other.end(), isImplied);
+    }
+
+    // A row matching any of the params must match the other params through each one of them.
+    const auto impliesOther = [&other, otherOrOp](const tp::SearchParam &param)
+    {
+        const auto impliesParam = [&param](const tp::SearchParam &otherParam) { return implies(param, otherParam); };
+        return otherOrOp ? std::any_of(other.begin(), other.end(), impliesParam)
+                         : std::all_of(other.begin(), other.end(), impliesParam);
+    };
+    return std::all_of(params.begin(), params.end(), impliesOther);
+}
+
+bool SearchCache::isSame(const Entry &entry, const tp::SearchParams &params, bool orOp)
+{
+    return implies(params, orOp, entry.params, entry.orOp) && implies(entry.params, entry.orOp, params, orOp);
+}
+
+bool SearchCache::implies(const tp::SearchParam &param, const tp::SearchParam &other)
+{
+    if (param == other)
+    {
+        return true;
+    }
+
+    const bool notOp(param.flags.has(tp::SearchFlag::NotOperator));
+    if ((param.type != tp::SearchType::SubString) || (other.type != tp::SearchType::SubString) ||
+        !(param.column == other.column) || (notOp != other.flags.has(tp::SearchFlag::NotOperator)))
+    {
+        return false;
+    }
+
+    const bool matchCase(param.flags.has(tp::SearchFlag::MatchCase));
+    const bool otherMatchCase(other.flags.has(tp::SearchFlag::MatchCase));
+    if (notOp)
+    {
+        // A row without the pattern has nothing containing it either.
+        return (!matchCase || otherMatchCase) && (other.pattern.find(param.pattern) != std::string::npos);
+    }
+
+    // A row containing the pattern contains any part of it as well.
+    return (matchCase || !otherMatchCase) && (param.pattern.find(other.pattern) != std::string::npos);
+}
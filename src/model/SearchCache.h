@@ -0,0 +1,46 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include "RowSet.h"
+#include <list>
+
+// Rows found by the last searches of a file, so repeating a search only searches the rows indexed since then,
+// and a narrower search, like one with an extra AND param or a longer substring, only matches the rows found by
+// a broader one.
+class SearchCache
+{
+public:
+    struct Entry
+    {
+        tp::SearchParams params;
+        bool orOp = false;
+        // Generation of the file's rows, which changes when the file is reloaded.
+        tp::UInt generation = 0;
+        RowSet rows;
+        // The rows before this one were all searched.
+        tp::UInt searchedRows = 0;
+    };
+    // The entries are shared, so they remain valid for the search using them after being replaced.
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    // Returns the entry with the same results as the params, or else the broader one leaving the fewest rows to
+    // match, or nullptr.
+    EntryPtr find(const tp::SearchParams &params, bool orOp, tp::UInt generation);
+    // Replaces the entry with the same results, and the entries of other generations.
+    void put(Entry &&entry);
+    void clear();
+
+    // Whether all the rows matching the params also match the other params.
+    static bool implies(const tp::SearchParams &params, bool orOp, const tp::SearchParams &other, bool otherOrOp);
+    static bool isSame(const Entry &entry, const tp::SearchParams &params, bool orOp);
+
+    static constexpr tp::UInt s_maxEntries = 8;
+
+private:
+    static bool implies(const tp::SearchParam &param, const tp::SearchParam &other);
+
+    // Most recently used first.
+    std::list<EntryPtr> m_entries;
+};
@@ -3,9 +3,51 @@
 
 #include "pch.h"
 #include "TextLogModel.h"
+#include "LineBreaks.h"
 
 constexpr tp::UInt g_maxChunksPerParse(500);
 
+namespace
+{
+
+struct SliceScan
+{
+    tp::UInt lineBreaks = 0;
+    std::optional<tp::UInt> lastLineBreakPos;
+    // Line breaks found before each checkpoint and the position of the row starting there.
+    std::vector<std::pair<tp::UInt, tp::UInt>> checkpoints;
+};
+
+// The data is scanned in blocks of g_checkpointSpacing bytes, and the row after the last line break of each
+// block becomes a checkpoint.
+SliceScan scanSlice(std::string_view data, tp::UInt startPos)
+{
+    SliceScan scan;
+    for (tp::UInt blockStart = 0; blockStart < data.size(); blockStart += g_checkpointSpacing)
+    {
+        const tp::UInt blockSize(std::min<tp::UInt>(g_checkpointSpacing, data.size() - blockStart));
+        const auto lineBreaks = utl::scanLineBreaks(data.data() + blockStart, blockSize);
+        if (lineBreaks.last != nullptr)
+        {
+            scan.lineBreaks += lineBreaks.count;
+            scan.lastLineBreakPos = startPos + (lineBreaks.last - data.data());
+            scan.checkpoints.emplace_back(scan.lineBreaks, scan.lastLineBreakPos.value() + 1);
+        }
+    }
+    return scan;
+}
+
+void addCheckpoints(Chunk &chunk, const SliceScan &scan)
+{
+    for (const auto &[lineBreaks, pos] : scan.checkpoints)
+    {
+        chunk.addCheckpoint(chunk.getFistRow() + lineBreaks, pos);
+    }
+    chunk.shrinkCheckpoints();
+}
+
+} // namespace
+
 TextLogModel::TextLogModel(FileConf::Ptr conf, QObject *parent) : BaseLogModel(conf, parent)
 {
 }
@@ -23,55 +65,58 @@ bool TextLogModel::configure(FileConf::Ptr conf, std::istream &is)
         {
             conf->addColumn(tp::Column(0));
         }
-        m_rx.setPattern(QString());
+        m_rx.setPattern(std::string());
     }
     else
     {
-        m_rx.setPattern(conf->getRegexPattern().c_str());
+        m_rx.setPattern(conf->getRegexPattern());
         if (!m_rx.isValid())
         {
-            LOG_ERR("Invalid regex pattern: '{}': {}", conf->getRegexPattern(), utl::toStr(m_rx.errorString()));
-            m_rx.setPattern(QString());
+            LOG_ERR("Invalid regex pattern: '{}': {}", conf->getRegexPattern(), m_rx.getErrorString());
+            m_rx.setPattern(std::string());
         }
     }
 
     return !conf->getColumns().empty();
 }
 
-bool TextLogModel::parseRow(const std::string &rawText, tp::RowData &rowData) const
+bool TextLogModel::parseRow(std::string_view rawText, tp::RowData &rowData) const
 {
-    if (m_rx.pattern().isEmpty())
+    if (m_rx.getPattern().empty())
     {
         rowData.emplace_back(rawText);
     }
     else
     {
-        QRegularExpressionMatch match = m_rx.match(rawText.c_str());
-        if (match.hasMatch())
+        // The rows are parsed by many threads, and each one reuses its groups.
+        thread_local std::vector<std::string> groups;
+        if (m_rx.match(rawText, groups))
         {
-            std::string value;
-
             for (const auto &col : getColumns())
             {
                 try
                 {
+                    int group(-1);
                     if (!col.key.empty())
                     {
                         if (QChar::isDigit(col.key.front()))
                         {
-                            value = match.captured(std::stoi(col.key)).toStdString();
+                            group = std::stoi(col.key);
                         }
                         else
                         {
-                            value = match.captured(col.key.c_str()).toStdString();
+                            group = m_rx.getGroupNumber(col.key);
                         }
                     }
+
+                    if ((group >= 0) && (static_cast<tp::UInt>(group) < groups.size()))
+                    {
+                        rowData.push_back(groups[group]);
+                    }
                     else
                     {
-                        value.clear();
+                        rowData.push_back(std::string());
                     }
-
-                    rowData.push_back(value);
                 }
                 catch (const std::exception &e)
                 {
@@ -100,10 +145,110 @@ tp::UInt TextLogModel::parseChunks(
     tp::UInt fromPos,
     tp::UInt nextRow,
     tp::UInt fileSize)
+{
+    // Parsing in parallel over the mapped file only pays off when there are multiple chunks. Smaller amounts,
+    // as the data appended to a followed file, are parsed straight from the stream.
+    if (((fileSize - fromPos) > g_chunkSize) && !isCompressed())
+    {
+        const auto map = MappedFile::make(getFileName());
+        if (map->contains(fromPos, fileSize - fromPos))
+        {
+            return parseMappedChunks(*map, chunks, fromPos, nextRow, fileSize);
+        }
+    }
+    return parseStreamChunks(is, chunks, fromPos, nextRow, fileSize);
+}
+
+tp::UInt TextLogModel::parseMappedChunks(
+    const MappedFile &map,
+    std::vector<Chunk> &chunks,
+    tp::UInt fromPos,
+    tp::UInt nextRow,
+    tp::UInt fileSize) const
+{
+    tp::UInt endPos(std::min<tp::UInt>(fileSize, fromPos + (g_chunkSize * g_maxChunksPerParse)));
+
+    while (true)
+    {
+        // The range is split into slices that are scanned for line breaks by all the cores.
+        const tp::UInt sliceCount((endPos - fromPos + g_chunkSize - 1) / g_chunkSize);
+        std::vector<SliceScan> slices(sliceCount);
+        std::atomic<tp::UInt> nextSlice(0);
+
+        const auto scanSlices = [&]()
+        {
+            for (tp::UInt i = nextSlice++; i < sliceCount; i = nextSlice++)
+            {
+                const tp::UInt sliceStart(fromPos + (i * g_chunkSize));
+                const tp::UInt sliceEnd(std::min<tp::UInt>(sliceStart + g_chunkSize, endPos));
+                slices[i] = scanSlice(map.view(sliceStart, sliceEnd - sliceStart), sliceStart);
+            }
+        };
+
+        const tp::UInt threadCount(std::min<tp::UInt>(std::max(std::thread::hardware_concurrency(), 1U), sliceCount));
+        std::vector<std::thread> workers;
+        workers.reserve(threadCount);
+        for (tp::UInt i = 1; i < threadCount; ++i)
+        {
+            workers.emplace_back(scanSlices);
+        }
+        scanSlices();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+
+        // Now that the line breaks of each slice are known, the chunks and their rows can be fixed up.
+        // A chunk ends at the last line break of a slice, so a slice with no line break is merged into the next one.
+        tp::UInt chunkStartPos(fromPos);
+        tp::UInt nextFirstChunkRow(nextRow);
+        for (const auto &slice : slices)
+        {
+            if (slice.lastLineBreakPos.has_value())
+            {
+                const tp::UInt chunkEndPos(slice.lastLineBreakPos.value() + 1);
+                chunks.emplace_back(
+                    chunkStartPos,
+                    chunkEndPos,
+                    nextFirstChunkRow,
+                    nextFirstChunkRow + slice.lineBreaks - 1);
+                addCheckpoints(chunks.back(), slice);
+                nextFirstChunkRow += slice.lineBreaks;
+                chunkStartPos = chunkEndPos;
+            }
+        }
+
+        if (chunkStartPos < endPos)
+        {
+            if (endPos == fileSize)
+            {
+                // The log does not end with a new line, so the extra characters are added as a new row.
+                chunks.emplace_back(chunkStartPos, fileSize, nextFirstChunkRow, nextFirstChunkRow);
+                return fileSize;
+            }
+            else if (chunkStartPos == fromPos)
+            {
+                // The row is bigger than the whole range, so the range is expanded.
+                endPos = std::min<tp::UInt>(fileSize, endPos + (endPos - fromPos));
+                continue;
+            }
+        }
+
+        // The characters after the last line break are included into the next parsing.
+        return chunkStartPos;
+    }
+}
+
+tp::UInt TextLogModel::parseStreamChunks(
+    std::istream &is,
+    std::vector<Chunk> &chunks,
+    tp::UInt fromPos,
+    tp::UInt nextRow,
+    tp::UInt fileSize) const
 {
     tp::UInt chunkSize(g_chunkSize);
     std::string buffer;
-    buffer.resize(g_chunkSize);
+    buffer.resize(std::min<tp::UInt>(g_chunkSize, fileSize - fromPos));
 
     const tp::UInt totalChunks(std::max<tp::UInt>((fileSize - fromPos) / g_chunkSize, 1));
     chunks.reserve(totalChunks);
@@ -125,15 +270,13 @@ tp::UInt TextLogModel::parseChunks(
 
         readFile(is, buffer, readBytes);
 
-        for (tp::UInt i = 0; i < readBytes; ++i)
+        const auto scan = scanSlice(std::string_view(buffer.data(), readBytes), chunkStartPos);
+        currentRowCount += scan.lineBreaks;
+        if (scan.lastLineBreakPos.has_value())
         {
-            ++lastPos;
-            if (buffer[i] == '\n')
-            {
-                ++currentRowCount;
-                lastLineBreakPos = lastPos;
-            }
+            lastLineBreakPos = scan.lastLineBreakPos.value() + 1;
         }
+        lastPos += readBytes;
 
         // Is there more characters after the last line break?
         if (lastPos > lastLineBreakPos)
@@ -165,6 +308,7 @@ tp::UInt TextLogModel::parseChunks(
         if (currentRowCount >= nextFirstChunkRow)
         {
             chunks.emplace_back(chunkStartPos, lastPos, nextFirstChunkRow, currentRowCount - 1);
+            addCheckpoints(chunks.back(), scan);
         }
         nextFirstChunkRow = currentRowCount;
     }
@@ -172,19 +316,25 @@ tp::UInt TextLogModel::parseChunks(
     return lastPos;
 }
 
-void TextLogModel::loadChunkRows(std::istream &is, ChunkRows &chunkRows) const
+void TextLogModel::loadChunkRows(ChunkRows &chunkRows) const
 {
-    moveFilePos(is, chunkRows.getChunk()->getStartPos());
-
-    const auto lastRow = chunkRows.getChunk()->getLastRow();
-    auto curentRow = chunkRows.getChunk()->getFistRow();
+    const auto lastRow = chunkRows.getLastRow();
+    auto curentRow = chunkRows.getFistRow();
 
     chunkRows.reserve(lastRow - curentRow + 1);
 
-    std::string line;
-    while ((curentRow <= lastRow) && std::getline(is, line))
+    const std::string_view data(chunkRows.getData());
+    std::string_view::size_type lineStart(0);
+    while ((curentRow <= lastRow) && (lineStart < data.size()))
     {
-        chunkRows.add(curentRow, line);
+        auto lineEnd = data.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos)
+        {
+            // The last row of the file may not end with a line break.
+            lineEnd = data.size();
+        }
+        chunkRows.add(curentRow, data.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
         ++curentRow;
     }
 }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "BaseLogModel.h"
+#include "Utf8Regex.h"
 
 class TextLogModel : public BaseLogModel
 {
@@ -15,15 +16,28 @@ public:
 
 protected:
     bool configure(FileConf::Ptr conf, std::istream &is) override;
-    bool parseRow(const std::string &rawText, tp::RowData &rowData) const override;
+    bool parseRow(std::string_view rawText, tp::RowData &rowData) const override;
     tp::UInt parseChunks(
         std::istream &is,
         std::vector<Chunk> &chunks,
         tp::UInt fromPos,
         tp::UInt nextRow,
         tp::UInt fileSize) override;
-    virtual void loadChunkRows(std::istream &is, ChunkRows &chunkRows) const override;
+    virtual void loadChunkRows(ChunkRows &chunkRows) const override;
 
 private:
-    QRegularExpression m_rx;
+    tp::UInt parseStreamChunks(
+        std::istream &is,
+        std::vector<Chunk> &chunks,
+        tp::UInt fromPos,
+        tp::UInt nextRow,
+        tp::UInt fileSize) const;
+    tp::UInt parseMappedChunks(
+        const MappedFile &map,
+        std::vector<Chunk> &chunks,
+        tp::UInt fromPos,
+        tp::UInt nextRow,
+        tp::UInt fileSize) const;
+
+    Utf8Regex m_rx;
 };
@@ -0,0 +1,173 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#include "pch.h"
+#include "TimeIndex.h"
+
+namespace
+{
+
+// Appends the rows [first, end), merging them into the last range when they overlap.
+void addRows(std::vector<std::pair<tp::UInt, tp::UInt>> &ranges, tp::UInt first, tp::UInt end)
+{
+    if (first >= end)
+    {
+        return;
+    }
+
+    if (!ranges.empty() && (first <= ranges.back().second))
+    {
+        ranges.back().second = std::max(ranges.back().second, end);
+    }
+    else
+    {
+        ranges.emplace_back(first, end);
+    }
+}
+
+} // namespace
+
+void TimeIndex::clear()
+{
+    m_samples.clear();
+    m_runs.clear();
+    m_chunkSamples.clear();
+    m_rowCount = 0;
+    m_timeRange.reset();
+}
+
+void TimeIndex::setColumn(const tp::Column *column)
+{
+    if (column == nullptr)
+    {
+        clear();
+        m_column.reset();
+        return;
+    }
+
+    if (m_column.has_value() && (m_column.value() == static_cast<tp::UInt>(column->idx)) &&
+        (m_parser.getFormat() == column->format))
+    {
+        return;
+    }
+
+    clear();
+    m_column = column->idx;
+    m_parser.setFormat(column->format);
+}
+
+void TimeIndex::addChunk(tp::UInt endRow, const std::vector<Sample> &samples)
+{
+    m_chunkSamples.push_back(m_samples.size());
+    m_rowCount = endRow;
+
+    for (const auto &sample : samples)
+    {
+        if (m_samples.empty() || (sample.time < m_samples.back().time))
+        {
+            m_runs.push_back(m_samples.size());
+        }
+        m_samples.push_back(sample);
+
+        if (m_timeRange.has_value())
+        {
+            m_timeRange->first = std::min(m_timeRange->first, sample.time);
+            m_timeRange->second = std::max(m_timeRange->second, sample.time);
+        }
+        else
+        {
+            m_timeRange = std::make_pair(sample.time, sample.time);
+        }
+    }
+}
+
+std::vector<TimeIndex::Sample> TimeIndex::getChunkSamples(tp::UInt chunk) const
+{
+    const tp::UInt first(m_chunkSamples[chunk]);
+    const tp::UInt last(((chunk + 1) < m_chunkSamples.size()) ? m_chunkSamples[chunk + 1] : m_samples.size());
+    return std::vector<Sample>(m_samples.begin() + first, m_samples.begin() + last);
+}
+
+std::optional<std::pair<std::int64_t, std::int64_t>> TimeIndex::getTimeRange() const
+{
+    return m_timeRange;
+}
+
+std::tuple<TimeIndex::SampleIt, TimeIndex::SampleIt, tp::UInt> TimeIndex::getRun(tp::UInt run) const
+{
+    const auto first = m_samples.begin() + m_runs[run];
+    if ((run + 1) < m_runs.size())
+    {
+        const auto last = m_samples.begin() + m_runs[run + 1];
+        return std::make_tuple(first, last, last->row);
+    }
+    return std::make_tuple(first, m_samples.end(), m_rowCount);
+}
+
+TimeIndex::RowsAt TimeIndex::findRows(std::int64_t time) const
+{
+    RowsAt rows;
+    for (tp::UInt run = 0; run < m_runs.size(); ++run)
+    {
+        const auto [first, last, endRow] = getRun(run);
+        const auto it = std::lower_bound(
+            first,
+            last,
+            time,
+            [](const Sample &sample, std::int64_t t) { return (sample.time < t); });
+
+        if (it != last)
+        {
+            // The rows since the previous sample may reach the time before the sampled one.
+            const tp::UInt firstRow((it != first) ? std::prev(it)->row : ((run == 0) ? 0 : first->row));
+            addRows(rows.ranges, firstRow, it->row);
+            rows.row = it->row;
+            return rows;
+        }
+
+        // The time goes back somewhere after the last sample of the run, which may be after reaching the time.
+        addRows(rows.ranges, std::prev(last)->row, endRow);
+    }
+    return rows;
+}
+
+std::vector<std::pair<tp::UInt, tp::UInt>> TimeIndex::findRangeRows(
+    std::optional<std::int64_t> from,
+    std::optional<std::int64_t> to) const
+{
+    std::vector<std::pair<tp::UInt, tp::UInt>> rows;
+    if (m_samples.empty())
+    {
+        return rows;
+    }
+
+    addRows(rows, 0, m_samples.front().row);
+    for (tp::UInt run = 0; run < m_runs.size(); ++run)
+    {
+        const auto [first, last, endRow] = getRun(run);
+        auto lower = first;
+        if (from.has_value())
+        {
+            lower = std::lower_bound(
+                first,
+                last,
+                from.value(),
+                [](const Sample &sample, std::int64_t t) { return (sample.time < t); });
+        }
+        auto upper = last;
+        if (to.has_value())
+        {
+            upper = std::upper_bound(
+                first,
+                last,
+                to.value(),
+                [](std::int64_t t, const Sample &sample) { return (t < sample.time); });
+        }
+
+        // The rows since the sample before the first one at or after from may reach it, and the rows up to
+        // the first sample after to may still be before it.
+        addRows(rows, (lower != first) ? std::prev(lower)->row : first->row, (upper != last) ? upper->row : endRow);
+        addRows(rows, std::prev(last)->row, endRow);
+    }
+    return rows;
+}
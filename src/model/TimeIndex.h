@@ -0,0 +1,67 @@
+// Copyright (C) 2022 Rafael Fassi Lobao
+// This file is part of qlogexplorer project licensed under GPL-3.0
+
+#pragma once
+
+#include "TimeParser.h"
+
+// Sparse index of the times of a log, with the time of the first timed row of each block between the row
+// checkpoints. The samples are split into runs where they don't decrease, and the rows of a block are taken
+// as ordered like the samples of its run. So the rows around a time are found by binary search inside each
+// run, and only the blocks where the time goes back are scanned.
+class TimeIndex
+{
+public:
+    struct Sample
+    {
+        tp::UInt row;
+        std::int64_t time;
+    };
+
+    // Rows to scan, in order, for the first row at or after a time.
+    struct RowsAt
+    {
+        std::vector<std::pair<tp::UInt, tp::UInt>> ranges;
+        // Sampled row at or after the time that ends the ranges, if any.
+        std::optional<tp::UInt> row;
+    };
+
+    void clear();
+    // Sets the time column, or none, clearing the index when it changes.
+    void setColumn(const tp::Column *column);
+    bool hasColumn() const { return m_column.has_value(); }
+    tp::UInt getColumn() const { return m_column.value(); }
+    const TimeParser &getParser() const { return m_parser; }
+
+    // Number of chunks already added, with or without samples.
+    tp::UInt getChunkCount() const { return m_chunkSamples.size(); }
+    // Number of rows in the chunks already added.
+    tp::UInt getRowCount() const { return m_rowCount; }
+    tp::UInt getRunCount() const { return m_runs.size(); }
+    // Adds the next chunk, ending before the end row, with the samples of its blocks in order.
+    void addChunk(tp::UInt endRow, const std::vector<Sample> &samples);
+    std::vector<Sample> getChunkSamples(tp::UInt chunk) const;
+    // The earliest and the latest sampled times, if any.
+    std::optional<std::pair<std::int64_t, std::int64_t>> getTimeRange() const;
+
+    RowsAt findRows(std::int64_t time) const;
+    // Ranges of rows [first, end), in order, that may hold the times between the bounds. The rows before the
+    // first sample and after the last one of each run are always included, as their order is unknown.
+    std::vector<std::pair<tp::UInt, tp::UInt>> findRangeRows(
+        std::optional<std::int64_t> from,
+        std::optional<std::int64_t> to) const;
+
+private:
+    using SampleIt = std::vector<Sample>::const_iterator;
+    // Samples [first, last) of the run and the row where it ends.
+    std::tuple<SampleIt, SampleIt, tp::UInt> getRun(tp::UInt run) const;
+
+    std::optional<tp::UInt> m_column;
+    TimeParser m_parser;
+    std::vector<Sample> m_samples;
+    // Index of the first sample of each run and of each chunk.
+    std::vector<tp::UInt> m_runs;
+    std::vector<tp::UInt> m_chunkSamples;
+    tp::UInt m_rowCount = 0;
+    std::optional<std::pair<std::int64_t, std::int64_t>> m_timeRange;
+};
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <queue>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <bitset>
@@ -36,6 +37,7 @@
 #include <3rdparty/rapidjson/writer.h>
 #include <3rdparty/rapidjson/prettywriter.h>
 #include <3rdparty/rapidjson/istreamwrapper.h>
+#include <3rdparty/rapidjson/memorystream.h>
 
 // fmt
 #define FMT_HEADER_ONLY 1